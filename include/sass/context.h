@@ -21,6 +21,32 @@ struct Sass_Context; // : Sass_Options
 struct Sass_File_Context; // : Sass_Context
 struct Sass_Data_Context; // : Sass_Context
 
+// Parts of the css passed to the output writer
+enum Sass_Output_Part {
+  // the css in order, passed while it is emitted
+  SASS_OUTPUT_BODY,
+  // charset, imports and comments hoisted to the top;
+  // passed last, but goes before the body, so a sink
+  // that cannot seek has to spool the body until then
+  SASS_OUTPUT_PREAMBLE
+};
+
+// Receives the css in chunks of up to 64KB while it is rendered
+// (the output string of the context stays null then)
+typedef void (*Sass_Output_Writer)
+  (const char* chunk, size_t length, enum Sass_Output_Part part, void* cookie);
+
+// How imports are resolved from cached directory
+// listings (shared by all contexts of the process)
+enum Sass_Directory_Index {
+  // probe every candidate on disk
+  SASS_DIRECTORY_INDEX_NONE,
+  // re-check listings by mtime once per compilation
+  SASS_DIRECTORY_INDEX_MTIME,
+  // keep listings until sass_clear_directory_index
+  SASS_DIRECTORY_INDEX_STATIC
+};
+
 // Compiler states
 enum Sass_Compiler_State {
   SASS_COMPILER_CREATED,
@@ -38,6 +64,23 @@ ADDAPI struct Sass_Data_Context* ADDCALL sass_make_data_context (char* source_st
 ADDAPI int ADDCALL sass_compile_file_context (struct Sass_File_Context* ctx);
 ADDAPI int ADDCALL sass_compile_data_context (struct Sass_Data_Context* ctx);
 
+// Compile many file contexts concurrently on a pool of `threads` workers
+// (pass 0 to use one worker per cpu core). Returns the number of failed
+// compilations; check each context for its individual results.
+ADDAPI size_t ADDCALL sass_compile_batch (struct Sass_File_Context** ctxs, size_t n, int threads);
+
+// Release all stylesheets cached by the process (those stored in
+// a `stylesheet_cache_path` directory are kept)
+ADDAPI void ADDCALL sass_clear_stylesheet_cache (void);
+
+// Forget all directory listings used to resolve imports
+ADDAPI void ADDCALL sass_clear_directory_index (void);
+
+// Parse the entry file and store its tree next to it (`.sassc` appended)
+// Compilations with `load_precompiled` set load it instead of parsing the
+// unchanged source again (changed or damaged sidecars are ignored)
+ADDAPI int ADDCALL sass_precompile_file_context (struct Sass_File_Context* ctx);
+
 // Create a sass compiler instance for more control
 ADDAPI struct Sass_Compiler* ADDCALL sass_make_file_compiler (struct Sass_File_Context* file_ctx);
 ADDAPI struct Sass_Compiler* ADDCALL sass_make_data_compiler (struct Sass_Data_Context* data_ctx);
@@ -77,15 +120,22 @@ ADDAPI bool ADDCALL sass_option_get_source_map_contents (struct Sass_Options* op
 ADDAPI bool ADDCALL sass_option_get_source_map_file_urls (struct Sass_Options* options);
 ADDAPI bool ADDCALL sass_option_get_omit_source_map_url (struct Sass_Options* options);
 ADDAPI bool ADDCALL sass_option_get_is_indented_syntax_src (struct Sass_Options* options);
+ADDAPI bool ADDCALL sass_option_get_stylesheet_cache (struct Sass_Options* options);
+ADDAPI bool ADDCALL sass_option_get_load_precompiled (struct Sass_Options* options);
+ADDAPI bool ADDCALL sass_option_get_map_files (struct Sass_Options* options);
+ADDAPI enum Sass_Directory_Index ADDCALL sass_option_get_directory_index (struct Sass_Options* options);
 ADDAPI const char* ADDCALL sass_option_get_indent (struct Sass_Options* options);
 ADDAPI const char* ADDCALL sass_option_get_linefeed (struct Sass_Options* options);
 ADDAPI const char* ADDCALL sass_option_get_input_path (struct Sass_Options* options);
 ADDAPI const char* ADDCALL sass_option_get_output_path (struct Sass_Options* options);
 ADDAPI const char* ADDCALL sass_option_get_source_map_file (struct Sass_Options* options);
 ADDAPI const char* ADDCALL sass_option_get_source_map_root (struct Sass_Options* options);
+ADDAPI const char* ADDCALL sass_option_get_stylesheet_cache_path (struct Sass_Options* options);
 ADDAPI Sass_Importer_List ADDCALL sass_option_get_c_headers (struct Sass_Options* options);
 ADDAPI Sass_Importer_List ADDCALL sass_option_get_c_importers (struct Sass_Options* options);
 ADDAPI Sass_Function_List ADDCALL sass_option_get_c_functions (struct Sass_Options* options);
+ADDAPI Sass_Output_Writer ADDCALL sass_option_get_output_writer (struct Sass_Options* options);
+ADDAPI void* ADDCALL sass_option_get_output_writer_cookie (struct Sass_Options* options);
 
 // Setters for Context_Option values
 ADDAPI void ADDCALL sass_option_set_precision (struct Sass_Options* options, int precision);
@@ -96,6 +146,10 @@ ADDAPI void ADDCALL sass_option_set_source_map_contents (struct Sass_Options* op
 ADDAPI void ADDCALL sass_option_set_source_map_file_urls (struct Sass_Options* options, bool source_map_file_urls);
 ADDAPI void ADDCALL sass_option_set_omit_source_map_url (struct Sass_Options* options, bool omit_source_map_url);
 ADDAPI void ADDCALL sass_option_set_is_indented_syntax_src (struct Sass_Options* options, bool is_indented_syntax_src);
+ADDAPI void ADDCALL sass_option_set_stylesheet_cache (struct Sass_Options* options, bool stylesheet_cache);
+ADDAPI void ADDCALL sass_option_set_load_precompiled (struct Sass_Options* options, bool load_precompiled);
+ADDAPI void ADDCALL sass_option_set_map_files (struct Sass_Options* options, bool map_files);
+ADDAPI void ADDCALL sass_option_set_directory_index (struct Sass_Options* options, enum Sass_Directory_Index directory_index);
 ADDAPI void ADDCALL sass_option_set_indent (struct Sass_Options* options, const char* indent);
 ADDAPI void ADDCALL sass_option_set_linefeed (struct Sass_Options* options, const char* linefeed);
 ADDAPI void ADDCALL sass_option_set_input_path (struct Sass_Options* options, const char* input_path);
@@ -104,9 +158,12 @@ ADDAPI void ADDCALL sass_option_set_plugin_path (struct Sass_Options* options, c
 ADDAPI void ADDCALL sass_option_set_include_path (struct Sass_Options* options, const char* include_path);
 ADDAPI void ADDCALL sass_option_set_source_map_file (struct Sass_Options* options, const char* source_map_file);
 ADDAPI void ADDCALL sass_option_set_source_map_root (struct Sass_Options* options, const char* source_map_root);
+ADDAPI void ADDCALL sass_option_set_stylesheet_cache_path (struct Sass_Options* options, const char* stylesheet_cache_path);
 ADDAPI void ADDCALL sass_option_set_c_headers (struct Sass_Options* options, Sass_Importer_List c_headers);
 ADDAPI void ADDCALL sass_option_set_c_importers (struct Sass_Options* options, Sass_Importer_List c_importers);
 ADDAPI void ADDCALL sass_option_set_c_functions (struct Sass_Options* options, Sass_Function_List c_functions);
+ADDAPI void ADDCALL sass_option_set_output_writer (struct Sass_Options* options, Sass_Output_Writer output_writer);
+ADDAPI void ADDCALL sass_option_set_output_writer_cookie (struct Sass_Options* options, void* output_writer_cookie);
 
 
 // Getters for Sass_Context values
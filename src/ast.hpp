@@ -5,6 +5,7 @@
 // __EXTENSIONS__ fix on Solaris.
 #include "sass.hpp"
 
+#include <cassert>
 #include <typeinfo>
 #include <unordered_map>
 
@@ -12,6 +13,7 @@
 #include "ast_helpers.hpp"
 #include "ast_fwd_decl.hpp"
 #include "ast_def_macros.hpp"
+#include "persistent_map.hpp"
 
 #include "file.hpp"
 #include "position.hpp"
@@ -56,12 +58,24 @@ namespace Sass {
   //////////////////////////////////////////////////////////
   class AST_Node : public SharedObj {
     ADD_PROPERTY(SourceSpan, pstate)
+  protected:
+    // set by the constructors of the concrete classes
+    NodeKind kind_;
+  public:
+    NodeKind kind() const {
+      #ifdef DEBUG
+      // a concrete class forgot to set its kind
+      assert(kind_ != NodeKind::None);
+      #endif
+      return kind_;
+    }
+    void kind(NodeKind kind) { kind_ = kind; }
   public:
     AST_Node(SourceSpan pstate)
-    : pstate_(pstate)
+    : pstate_(pstate), kind_(NodeKind::None)
     { }
     AST_Node(const AST_Node* ptr)
-    : pstate_(ptr->pstate_)
+    : pstate_(ptr->pstate_), kind_(ptr->kind_)
     { }
 
     // allow implicit conversion to string
@@ -111,13 +125,13 @@ namespace Sass {
 
   template<class T>
   T* Cast(AST_Node* ptr) {
-    return ptr && typeid(T) == typeid(*ptr) ?
+    return ptr && NodeKinds<T>::contains(ptr->kind()) ?
            static_cast<T*>(ptr) : NULL;
   };
 
   template<class T>
   const T* Cast(const AST_Node* ptr) {
-    return ptr && typeid(T) == typeid(*ptr) ?
+    return ptr && NodeKinds<T>::contains(ptr->kind()) ?
            static_cast<const T*>(ptr) : NULL;
   };
 
@@ -206,11 +220,21 @@ namespace Sass {
   /////////////////////////////////////////////////////////////////////////////
   // Mixin class for AST nodes that should behave like vectors. Uses the
   // "Template Method" design pattern to allow subclasses to adjust their flags
-  // when certain objects are pushed.
+  // when certain objects are pushed. The elements are kept in a sass::vector,
+  // or in any container [V] with the same interface (see `shared_vector`).
+  // Non-const access returns the references and iterators of [V], which are
+  // read-only for containers that share their elements (change them with
+  // `set` and the modifiers).
   /////////////////////////////////////////////////////////////////////////////
-  template <typename T>
+  template <typename T, typename V = sass::vector<T>>
   class Vectorized {
-    sass::vector<T> elements_;
+    V elements_;
+    // how `set` replaces an element in [V]
+    static void assign(sass::vector<T>& elements, size_t i, const T& element)
+    { elements[i] = element; }
+    template <typename C>
+    static void assign(C& elements, size_t i, const T& element)
+    { elements.set(i, element); }
   protected:
     mutable size_t hash_;
     void reset_hash() { hash_ = 0; }
@@ -218,7 +242,7 @@ namespace Sass {
   public:
     Vectorized(size_t s = 0) : hash_(0)
     { elements_.reserve(s); }
-    Vectorized(sass::vector<T> vec) :
+    Vectorized(V vec) :
       elements_(std::move(vec)),
       hash_(0)
     {}
@@ -226,55 +250,57 @@ namespace Sass {
     size_t length() const   { return elements_.size(); }
     bool empty() const      { return elements_.empty(); }
     void clear()            { return elements_.clear(); }
-    T& last()               { return elements_.back(); }
-    T& first()              { return elements_.front(); }
+    typename V::reference last()  { return elements_.back(); }
+    typename V::reference first() { return elements_.front(); }
     const T& last() const   { return elements_.back(); }
     const T& first() const  { return elements_.front(); }
 
-    bool operator== (const Vectorized<T>& rhs) const {
+    bool operator== (const Vectorized<T, V>& rhs) const {
       // Abort early if sizes do not match
       if (length() != rhs.length()) return false;
       // Otherwise test each node for object equalicy in order
       return std::equal(begin(), end(), rhs.begin(), ObjEqualityFn<T>);
     }
 
-    bool operator!= (const Vectorized<T>& rhs) const {
+    bool operator!= (const Vectorized<T, V>& rhs) const {
       return !(*this == rhs);
     }
 
-    T& operator[](size_t i) { return elements_[i]; }
+    typename V::reference operator[](size_t i) { return elements_[i]; }
     virtual const T& at(size_t i) const { return elements_.at(i); }
-    virtual T& at(size_t i) { return elements_.at(i); }
+    virtual typename V::reference at(size_t i) { return elements_.at(i); }
     const T& get(size_t i) const { return elements_[i]; }
     const T& operator[](size_t i) const { return elements_[i]; }
 
-    // Implicitly get the sass::vector from our object
+    // Implicitly get the sass::vector (or V) from our object
     // Makes the Vector directly assignable to sass::vector
     // You are responsible to make a copy if needed
     // Note: since this returns the real object, we can't
     // Note: guarantee that the hash will not get out of sync
-    operator sass::vector<T>&() { return elements_; }
-    operator const sass::vector<T>&() const { return elements_; }
+    operator V&() { return elements_; }
+    operator const V&() const { return elements_; }
 
     // Explicitly request all elements as a real sass::vector
     // You are responsible to make a copy if needed
     // Note: since this returns the real object, we can't
     // Note: guarantee that the hash will not get out of sync
-    sass::vector<T>& elements() { return elements_; }
-    const sass::vector<T>& elements() const { return elements_; }
+    V& elements() { return elements_; }
+    const V& elements() const { return elements_; }
 
     // Insert all items from compatible vector
-    void concat(const sass::vector<T>& v)
+    void concat(const V& v)
     {
       if (!v.empty()) reset_hash();
-      elements().insert(end(), v.begin(), v.end());
+      elements_.insert(elements_.cend(), v.begin(), v.end());
     }
 
     // Syntatic sugar for pointers
-    void concat(const Vectorized<T>* v)
+    void concat(const Vectorized<T, V>* v)
     {
       if (v != nullptr) {
-        return concat(*v);
+        // shares the elements if V does
+        if (empty()) elements(v->elements_);
+        else return concat(*v);
       }
     }
 
@@ -299,7 +325,7 @@ namespace Sass {
     void append(T element)
     {
       reset_hash();
-      elements_.insert(end(), element);
+      elements_.push_back(element);
       // ToDo: Mostly used by parameters and arguments
       // ToDo: Find a more elegant way to support this
       adjust_after_pushing(element);
@@ -319,8 +345,15 @@ namespace Sass {
       return false;
     }
 
+    // Replace the element at [i]
+    void set(size_t i, const T& element)
+    {
+      reset_hash();
+      assign(elements_, i, element);
+    }
+
     // This might be better implemented as `operator=`?
-    void elements(sass::vector<T> e) {
+    void elements(V e) {
       reset_hash();
       elements_ = std::move(e);
     }
@@ -335,36 +368,56 @@ namespace Sass {
       return hash_;
     }
 
-    template <typename P, typename V>
-    typename sass::vector<T>::iterator insert(P position, const V& val) {
+    template <typename P, typename E>
+    typename V::iterator insert(P position, const E& val) {
       reset_hash();
       return elements_.insert(position, val);
     }
 
-    typename sass::vector<T>::iterator end() { return elements_.end(); }
-    typename sass::vector<T>::iterator begin() { return elements_.begin(); }
-    typename sass::vector<T>::const_iterator end() const { return elements_.end(); }
-    typename sass::vector<T>::const_iterator begin() const { return elements_.begin(); }
-    typename sass::vector<T>::iterator erase(typename sass::vector<T>::iterator el) { reset_hash(); return elements_.erase(el); }
-    typename sass::vector<T>::const_iterator erase(typename sass::vector<T>::const_iterator el) { reset_hash(); return elements_.erase(el); }
+    typename V::iterator end() { return elements_.end(); }
+    typename V::iterator begin() { return elements_.begin(); }
+    typename V::const_iterator end() const { return elements_.end(); }
+    typename V::const_iterator begin() const { return elements_.begin(); }
+    typename V::iterator erase(typename V::const_iterator el) { reset_hash(); return elements_.erase(el); }
 
   };
-  template <typename T>
-  inline Vectorized<T>::~Vectorized() { }
+  template <typename T, typename V>
+  inline Vectorized<T, V>::~Vectorized() { }
 
   /////////////////////////////////////////////////////////////////////////////
-  // Mixin class for AST nodes that should behave like a hash table. Uses an
-  // extra <sass::vector> internally to maintain insertion order for interation.
+  // Mixin class for AST nodes that should behave like a hash table. Backed by
+  // a persistent map, so copies (and maps merged into empty ones) share all
+  // entries. Keys and values are only listed (in order) when asked for.
   /////////////////////////////////////////////////////////////////////////////
   template <typename K, typename T, typename U>
   class Hashed {
   private:
-    std::unordered_map<
+    persistent_map<
       K, T, ObjHash, ObjEquality
     > elements_;
 
-    sass::vector<K> _keys;
-    sass::vector<T> _values;
+    mutable sass::vector<K> _keys;
+    mutable sass::vector<T> _values;
+    mutable bool listed_;
+
+    void list() const
+    {
+      if (listed_) return;
+      _keys.reserve(elements_.size());
+      _values.reserve(elements_.size());
+      elements_.for_each([this](const K& key, const T& value) {
+        _keys.push_back(key);
+        _values.push_back(value);
+      });
+      listed_ = true;
+    }
+    void unlist()
+    {
+      if (!listed_) return;
+      _keys.clear();
+      _values.clear();
+      listed_ = false;
+    }
   protected:
     mutable size_t hash_;
     K duplicate_key_;
@@ -376,74 +429,67 @@ namespace Sass {
     : elements_(),
       _keys(),
       _values(),
+      listed_(false),
       hash_(0), duplicate_key_({})
-    {
-      _keys.reserve(s);
-      _values.reserve(s);
-      elements_.reserve(s);
-    }
+    { }
+    Hashed(const Hashed& h)
+    : elements_(h.elements_),
+      _keys(),
+      _values(),
+      listed_(false),
+      hash_(h.hash_), duplicate_key_(h.duplicate_key_)
+    { }
     virtual ~Hashed();
-    size_t length() const                  { return _keys.size(); }
-    bool empty() const                     { return _keys.empty(); }
+    size_t length() const                  { return elements_.size(); }
+    bool empty() const                     { return elements_.empty(); }
     bool has(K k) const          {
-      return elements_.find(k) != elements_.end();
+      return elements_.has(k);
     }
     T at(K k) const {
-      if (elements_.count(k))
-      {
-        return elements_.at(k);
+      if (const T* value = elements_.find(k)) {
+        return *value;
       }
       else { return {}; }
     }
     bool has_duplicate_key() const         { return duplicate_key_ != nullptr; }
     K get_duplicate_key() const  { return duplicate_key_; }
-    const std::unordered_map<
-      K, T, ObjHash, ObjEquality
-    >& elements() { return elements_; }
     Hashed& operator<<(std::pair<K, T> p)
     {
       reset_hash();
+      unlist();
 
-      if (!has(p.first)) {
-        _keys.push_back(p.first);
-        _values.push_back(p.second);
-      }
-      else if (!duplicate_key_) {
+      if (!elements_.insert(p.first, p.second) && !duplicate_key_) {
         duplicate_key_ = p.first;
       }
 
-      elements_[p.first] = p.second;
-
       adjust_after_pushing(p);
       return *this;
     }
     Hashed& operator+=(Hashed* h)
     {
       if (length() == 0) {
+        unlist();
         this->elements_ = h->elements_;
-        this->_values = h->_values;
-        this->_keys = h->_keys;
         return *this;
       }
 
-      for (auto key : h->keys()) {
-        *this << std::make_pair(key, h->at(key));
-      }
+      h->elements_.for_each([this](const K& key, const T& value) {
+        *this << std::make_pair(key, value);
+      });
 
       reset_duplicate_key();
       return *this;
     }
-    const std::unordered_map<
-      K, T, ObjHash, ObjEquality
-    >& pairs() const { return elements_; }
-
-    const sass::vector<K>& keys() const { return _keys; }
-    const sass::vector<T>& values() const { return _values; }
+    // Removes the key, returns false if not found
+    bool erase(K k)
+    {
+      reset_hash();
+      unlist();
+      return elements_.erase(k);
+    }
 
-//    std::unordered_map<ExpressionObj, ExpressionObj>::iterator end() { return elements_.end(); }
-//    std::unordered_map<ExpressionObj, ExpressionObj>::iterator begin() { return elements_.begin(); }
-//    std::unordered_map<ExpressionObj, ExpressionObj>::const_iterator end() const { return elements_.end(); }
-//    std::unordered_map<ExpressionObj, ExpressionObj>::const_iterator begin() const { return elements_.begin(); }
+    const sass::vector<K>& keys() const { list(); return _keys; }
+    const sass::vector<T>& values() const { list(); return _values; }
 
   };
   template <typename K, typename T, typename U>
@@ -615,12 +661,15 @@ namespace Sass {
   // Assignments -- variable and value.
   /////////////////////////////////////
   class Assignment final : public Statement {
-    ADD_CONSTREF(sass::string, variable)
+    // interned variable name
+    ADD_CONSTREF(Symbol, symbol)
     ADD_PROPERTY(ExpressionObj, value)
     ADD_PROPERTY(bool, is_default)
     ADD_PROPERTY(bool, is_global)
   public:
     Assignment(SourceSpan pstate, sass::string var, ExpressionObj val, bool is_default = false, bool is_global = false);
+    const sass::string& variable() const { return symbol_.str(); }
+    void variable(const sass::string& variable) { symbol_ = variable; }
     ATTACH_AST_OPERATIONS(Assignment)
     ATTACH_CRTP_PERFORM_METHODS()
   };
@@ -802,10 +851,16 @@ namespace Sass {
   // Mixin calls (i.e., `@include ...`).
   //////////////////////////////////////
   class Mixin_Call final : public ParentStatement {
-    ADD_CONSTREF(sass::string, name)
     ADD_PROPERTY(Arguments_Obj, arguments)
     ADD_PROPERTY(Parameters_Obj, block_parameters)
+  protected:
+    sass::string name_;
+    // environment key of the mixin
+    Symbol lookup_;
   public:
+    const sass::string& name() const { return name_; }
+    void name(const sass::string& name);
+    const Symbol& lookup() const { return lookup_; }
     Mixin_Call(SourceSpan pstate, sass::string n, Arguments_Obj args, Parameters_Obj b_params = {}, Block_Obj b = {});
     ATTACH_AST_OPERATIONS(Mixin_Call)
     ATTACH_CRTP_PERFORM_METHODS()
@@ -1025,11 +1080,14 @@ namespace Sass {
   // Individual parameter objects for mixins and functions.
   /////////////////////////////////////////////////////////
   class Parameter final : public AST_Node {
-    ADD_CONSTREF(sass::string, name)
+    // interned name, bound on every call
+    ADD_CONSTREF(Symbol, symbol)
     ADD_PROPERTY(ExpressionObj, default_value)
     ADD_PROPERTY(bool, is_rest_parameter)
   public:
     Parameter(SourceSpan pstate, sass::string n, ExpressionObj def = {}, bool rest = false);
+    const sass::string& name() const { return symbol_.str(); }
+    void name(const sass::string& name) { symbol_ = name; }
     ATTACH_AST_OPERATIONS(Parameter)
     ATTACH_CRTP_PERFORM_METHODS()
   };
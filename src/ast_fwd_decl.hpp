@@ -221,44 +221,219 @@ namespace Sass {
   typedef sass::vector<SelectorListObj> SelectorStack;
   typedef sass::vector<Sass_Import_Entry> ImporterStack;
 
-  // only to switch implementations for testing
-  #define environment_map std::map
-
   // ###########################################################################
-  // explicit type conversion functions
+  // node kinds, one for every concrete class (stored in each node)
   // ###########################################################################
 
+  // Sub-classes follow their base class, so every base class
+  // maps to a contiguous range and `Cast` is a range check.
+  enum class NodeKind : uint8_t {
+    // not set yet (part of no range)
+    None,
+    // Expression
+    //   PreValue
+    //     Value
+    List,
+    Map,
+    Function,
+    Number,
+    //       Color
+    Color_RGBA,
+    Color_HSLA,
+    Custom_Error,
+    Custom_Warning,
+    Boolean,
+    //       String
+    String_Schema,
+    //         String_Constant
+    String_Constant,
+    String_Quoted,
+    Null,
+    Parent_Reference,
+    Binary_Expression,
+    Function_Call,
+    Variable,
+    Unary_Expression,
+    Argument,
+    Arguments,
+    Media_Query,
+    Media_Query_Expression,
+    At_Root_Query,
+    //   Selector
+    //     SimpleSelector
+    PlaceholderSelector,
+    TypeSelector,
+    ClassSelector,
+    IDSelector,
+    AttributeSelector,
+    PseudoSelector,
+    //     SelectorComponent
+    SelectorCombinator,
+    CompoundSelector,
+    ComplexSelector,
+    SelectorList,
+    //   SupportsCondition
+    SupportsCondition,
+    SupportsOperation,
+    SupportsNegation,
+    SupportsDeclaration,
+    Supports_Interpolation,
+    // Statement
+    Block,
+    Bubble,
+    Assignment,
+    Import,
+    Import_Stub,
+    WarningRule,
+    ErrorRule,
+    DebugRule,
+    Comment,
+    Return,
+    Content,
+    ExtendRule,
+    //   ParentStatement
+    StyleRule,
+    Trace,
+    AtRule,
+    Keyframe_Rule,
+    Declaration,
+    If,
+    ForRule,
+    EachRule,
+    WhileRule,
+    Definition,
+    Mixin_Call,
+    MediaRule,
+    CssMediaRule,
+    AtRootRule,
+    SupportsRule,
+    // other nodes
+    CssMediaQuery,
+    Selector_Schema,
+    Parameter,
+    Parameters
+  };
+
+  // Range of kinds belonging to the class (final by default)
   template<class T>
-  T* Cast(AST_Node* ptr);
+  struct NodeKinds;
 
   template<class T>
-  const T* Cast(const AST_Node* ptr);
+  struct NodeKinds<const T> : NodeKinds<T> { };
+
+  #define DECLARE_NODE_KINDS(T, FIRST, LAST) \
+  template<> struct NodeKinds<T> { \
+    static bool contains(NodeKind kind) { \
+      return kind >= NodeKind::FIRST && kind <= NodeKind::LAST; \
+    } \
+  }; \
+
+  #define DECLARE_NODE_KIND(T) \
+  template<> struct NodeKinds<T> { \
+    static bool contains(NodeKind kind) { \
+      return kind == NodeKind::T; \
+    } \
+  }; \
+
+  // ###########################################################################
+  // ranges for base classes (and concrete classes with sub-classes)
+  // ###########################################################################
+
+  DECLARE_NODE_KINDS(AST_Node, List, Parameters)
+  DECLARE_NODE_KINDS(Expression, List, Supports_Interpolation)
+  DECLARE_NODE_KINDS(PreValue, List, Variable)
+  DECLARE_NODE_KINDS(Value, List, Parent_Reference)
+  DECLARE_NODE_KINDS(Color, Color_RGBA, Color_HSLA)
+  DECLARE_NODE_KINDS(String, String_Schema, String_Quoted)
+  DECLARE_NODE_KINDS(String_Constant, String_Constant, String_Quoted)
+  DECLARE_NODE_KINDS(Selector, PlaceholderSelector, SelectorList)
+  DECLARE_NODE_KINDS(SimpleSelector, PlaceholderSelector, PseudoSelector)
+  DECLARE_NODE_KINDS(SelectorComponent, SelectorCombinator, CompoundSelector)
+  DECLARE_NODE_KINDS(SupportsCondition, SupportsCondition, Supports_Interpolation)
+  DECLARE_NODE_KINDS(Statement, Block, SupportsRule)
+  DECLARE_NODE_KINDS(ParentStatement, StyleRule, SupportsRule)
 
-  // sometimes you know the class you want to cast to is final
-  // in this case a simple typeid check is faster and safe to use
+  // ###########################################################################
+  // single kind for all final classes
+  // ###########################################################################
 
-  #define DECLARE_BASE_CAST(T) \
-  template<> T* Cast(AST_Node* ptr); \
-  template<> const T* Cast(const AST_Node* ptr); \
+  DECLARE_NODE_KIND(List)
+  DECLARE_NODE_KIND(Map)
+  DECLARE_NODE_KIND(Function)
+  DECLARE_NODE_KIND(Number)
+  DECLARE_NODE_KIND(Color_RGBA)
+  DECLARE_NODE_KIND(Color_HSLA)
+  DECLARE_NODE_KIND(Custom_Error)
+  DECLARE_NODE_KIND(Custom_Warning)
+  DECLARE_NODE_KIND(Boolean)
+  DECLARE_NODE_KIND(String_Schema)
+  DECLARE_NODE_KIND(String_Quoted)
+  DECLARE_NODE_KIND(Null)
+  DECLARE_NODE_KIND(Parent_Reference)
+  DECLARE_NODE_KIND(Binary_Expression)
+  DECLARE_NODE_KIND(Function_Call)
+  DECLARE_NODE_KIND(Variable)
+  DECLARE_NODE_KIND(Unary_Expression)
+  DECLARE_NODE_KIND(Argument)
+  DECLARE_NODE_KIND(Arguments)
+  DECLARE_NODE_KIND(Media_Query)
+  DECLARE_NODE_KIND(Media_Query_Expression)
+  DECLARE_NODE_KIND(At_Root_Query)
+  DECLARE_NODE_KIND(PlaceholderSelector)
+  DECLARE_NODE_KIND(TypeSelector)
+  DECLARE_NODE_KIND(ClassSelector)
+  DECLARE_NODE_KIND(IDSelector)
+  DECLARE_NODE_KIND(AttributeSelector)
+  DECLARE_NODE_KIND(PseudoSelector)
+  DECLARE_NODE_KIND(SelectorCombinator)
+  DECLARE_NODE_KIND(CompoundSelector)
+  DECLARE_NODE_KIND(ComplexSelector)
+  DECLARE_NODE_KIND(SelectorList)
+  DECLARE_NODE_KIND(SupportsOperation)
+  DECLARE_NODE_KIND(SupportsNegation)
+  DECLARE_NODE_KIND(SupportsDeclaration)
+  DECLARE_NODE_KIND(Supports_Interpolation)
+  DECLARE_NODE_KIND(Block)
+  DECLARE_NODE_KIND(Bubble)
+  DECLARE_NODE_KIND(Assignment)
+  DECLARE_NODE_KIND(Import)
+  DECLARE_NODE_KIND(Import_Stub)
+  DECLARE_NODE_KIND(WarningRule)
+  DECLARE_NODE_KIND(ErrorRule)
+  DECLARE_NODE_KIND(DebugRule)
+  DECLARE_NODE_KIND(Comment)
+  DECLARE_NODE_KIND(Return)
+  DECLARE_NODE_KIND(Content)
+  DECLARE_NODE_KIND(ExtendRule)
+  DECLARE_NODE_KIND(StyleRule)
+  DECLARE_NODE_KIND(Trace)
+  DECLARE_NODE_KIND(AtRule)
+  DECLARE_NODE_KIND(Keyframe_Rule)
+  DECLARE_NODE_KIND(Declaration)
+  DECLARE_NODE_KIND(If)
+  DECLARE_NODE_KIND(ForRule)
+  DECLARE_NODE_KIND(EachRule)
+  DECLARE_NODE_KIND(WhileRule)
+  DECLARE_NODE_KIND(Definition)
+  DECLARE_NODE_KIND(Mixin_Call)
+  DECLARE_NODE_KIND(MediaRule)
+  DECLARE_NODE_KIND(CssMediaRule)
+  DECLARE_NODE_KIND(AtRootRule)
+  DECLARE_NODE_KIND(SupportsRule)
+  DECLARE_NODE_KIND(CssMediaQuery)
+  DECLARE_NODE_KIND(Selector_Schema)
+  DECLARE_NODE_KIND(Parameter)
+  DECLARE_NODE_KIND(Parameters)
 
   // ###########################################################################
-  // implement specialization for final classes
+  // explicit type conversion functions (defined in ast.hpp)
   // ###########################################################################
 
-  DECLARE_BASE_CAST(AST_Node)
-  DECLARE_BASE_CAST(Expression)
-  DECLARE_BASE_CAST(Statement)
-  DECLARE_BASE_CAST(ParentStatement)
-  DECLARE_BASE_CAST(PreValue)
-  DECLARE_BASE_CAST(Value)
-  DECLARE_BASE_CAST(List)
-  DECLARE_BASE_CAST(Color)
-  DECLARE_BASE_CAST(String)
-  DECLARE_BASE_CAST(String_Constant)
-  DECLARE_BASE_CAST(SupportsCondition)
-  DECLARE_BASE_CAST(Selector)
-  DECLARE_BASE_CAST(SimpleSelector)
-  DECLARE_BASE_CAST(SelectorComponent)
+  template<class T>
+  T* Cast(AST_Node* ptr);
+
+  template<class T>
+  const T* Cast(const AST_Node* ptr);
 
 }
 
@@ -71,6 +71,10 @@ namespace Sass {
   {
     if (&rhs == this) return true;
     if (rhs.length() != length()) return false;
+    // Copies of a list share its complex selectors (in order)
+    size_t same = 0;
+    while (same < length() && get(same) == rhs.get(same)) same += 1;
+    if (same == length()) return true;
     std::unordered_set<const ComplexSelector*, PtrObjHash, PtrObjEquality> lhs_set;
     lhs_set.reserve(length());
     for (const ComplexSelectorObj& element : elements()) {
@@ -124,6 +128,7 @@ namespace Sass {
 
   bool ComplexSelector::operator== (const ComplexSelector& rhs) const
   {
+    if (&rhs == this) return true;
     size_t len = length();
     size_t rlen = rhs.length();
     if (len != rlen) return false;
@@ -207,6 +212,21 @@ namespace Sass {
     // std::cerr << "comp vs comp\n";
     if (&rhs == this) return true;
     if (rhs.length() != length()) return false;
+    // Compounds are short, a linear search beats building a set
+    // (and the extender shares simple selectors between compounds).
+    if (length() <= 8) {
+      for (const SimpleSelectorObj& element : rhs.elements()) {
+        bool found = false;
+        for (const SimpleSelectorObj& other : elements()) {
+          if (element == other || *element == *other) {
+            found = true;
+            break;
+          }
+        }
+        if (!found) return false;
+      }
+      return true;
+    }
     std::unordered_set<const SimpleSelector*, PtrObjHash, PtrObjEquality> lhs_set;
     lhs_set.reserve(length());
     for (const SimpleSelectorObj& element : elements()) {
@@ -521,6 +521,35 @@ namespace Sass {
   }
   // EO listIsSuperslector
 
+  // ##########################################################################
+  // Returns the bitsets of [complex] (see SuperselectorSignature). Simple
+  // selectors are only equal if their kind and name are equal, and only
+  // pseudo selectors with a selector argument match other selectors.
+  // ##########################################################################
+  SuperselectorSignature superselectorSignature(
+    const ComplexSelector* complex)
+  {
+    SuperselectorSignature signature;
+    for (const SelectorComponentObj& component : complex->elements()) {
+      const CompoundSelector* compound = component->getCompound();
+      if (compound == nullptr) continue;
+      for (const SimpleSelectorObj& simple : compound->elements()) {
+        const PseudoSelector* pseudo = simple->getPseudoSelector();
+        if (pseudo && pseudo->selector()) {
+          signature.provided = ~uint64_t(0);
+          continue;
+        }
+        size_t hash = std::hash<sass::string>()(simple->name());
+        hash_combine(hash, (int)simple->simple_type());
+        uint64_t bit = uint64_t(1) << (hash % 64);
+        signature.required |= bit;
+        signature.provided |= bit;
+      }
+    }
+    return signature;
+  }
+  // EO superselectorSignature
+
   // ##########################################################################
   // Implement selector methods (dispatch to functions)
   // ##########################################################################
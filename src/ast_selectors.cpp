@@ -35,13 +35,13 @@ namespace Sass {
     contents_(c),
     connect_parent_(true),
     hash_(0)
-  { }
+  { kind(NodeKind::Selector_Schema); }
   Selector_Schema::Selector_Schema(const Selector_Schema* ptr)
   : AST_Node(ptr),
     contents_(ptr->contents_),
     connect_parent_(ptr->connect_parent_),
     hash_(ptr->hash_)
-  { }
+  { kind(NodeKind::Selector_Schema); }
 
   unsigned long Selector_Schema::specificity() const
   {
@@ -176,10 +176,10 @@ namespace Sass {
 
   PlaceholderSelector::PlaceholderSelector(SourceSpan pstate, sass::string n)
   : SimpleSelector(pstate, n)
-  { simple_type(PLACEHOLDER_SEL); }
+  { kind(NodeKind::PlaceholderSelector); simple_type(PLACEHOLDER_SEL); }
   PlaceholderSelector::PlaceholderSelector(const PlaceholderSelector* ptr)
   : SimpleSelector(ptr)
-  { simple_type(PLACEHOLDER_SEL); }
+  { kind(NodeKind::PlaceholderSelector); simple_type(PLACEHOLDER_SEL); }
   unsigned long PlaceholderSelector::specificity() const
   {
     return Constants::Specificity_Base;
@@ -193,10 +193,10 @@ namespace Sass {
 
   TypeSelector::TypeSelector(SourceSpan pstate, sass::string n)
   : SimpleSelector(pstate, n)
-  { simple_type(TYPE_SEL); }
+  { kind(NodeKind::TypeSelector); simple_type(TYPE_SEL); }
   TypeSelector::TypeSelector(const TypeSelector* ptr)
   : SimpleSelector(ptr)
-  { simple_type(TYPE_SEL); }
+  { kind(NodeKind::TypeSelector); simple_type(TYPE_SEL); }
 
   unsigned long TypeSelector::specificity() const
   {
@@ -209,10 +209,10 @@ namespace Sass {
 
   ClassSelector::ClassSelector(SourceSpan pstate, sass::string n)
   : SimpleSelector(pstate, n)
-  { simple_type(CLASS_SEL); }
+  { kind(NodeKind::ClassSelector); simple_type(CLASS_SEL); }
   ClassSelector::ClassSelector(const ClassSelector* ptr)
   : SimpleSelector(ptr)
-  { simple_type(CLASS_SEL); }
+  { kind(NodeKind::ClassSelector); simple_type(CLASS_SEL); }
 
   unsigned long ClassSelector::specificity() const
   {
@@ -224,10 +224,10 @@ namespace Sass {
 
   IDSelector::IDSelector(SourceSpan pstate, sass::string n)
   : SimpleSelector(pstate, n)
-  { simple_type(ID_SEL); }
+  { kind(NodeKind::IDSelector); simple_type(ID_SEL); }
   IDSelector::IDSelector(const IDSelector* ptr)
   : SimpleSelector(ptr)
-  { simple_type(ID_SEL); }
+  { kind(NodeKind::IDSelector); simple_type(ID_SEL); }
 
   unsigned long IDSelector::specificity() const
   {
@@ -239,13 +239,13 @@ namespace Sass {
 
   AttributeSelector::AttributeSelector(SourceSpan pstate, sass::string n, sass::string m, String_Obj v, char o)
   : SimpleSelector(pstate, n), matcher_(m), value_(v), modifier_(o)
-  { simple_type(ATTRIBUTE_SEL); }
+  { kind(NodeKind::AttributeSelector); simple_type(ATTRIBUTE_SEL); }
   AttributeSelector::AttributeSelector(const AttributeSelector* ptr)
   : SimpleSelector(ptr),
     matcher_(ptr->matcher_),
     value_(ptr->value_),
     modifier_(ptr->modifier_)
-  { simple_type(ATTRIBUTE_SEL); }
+  { kind(NodeKind::AttributeSelector); simple_type(ATTRIBUTE_SEL); }
 
   size_t AttributeSelector::hash() const
   {
@@ -272,7 +272,7 @@ namespace Sass {
     selector_({}),
     isSyntacticClass_(!element),
     isClass_(!element && !isFakePseudoElement(normalized_))
-  { simple_type(PSEUDO_SEL); }
+  { kind(NodeKind::PseudoSelector); simple_type(PSEUDO_SEL); }
   PseudoSelector::PseudoSelector(const PseudoSelector* ptr)
   : SimpleSelector(ptr),
     normalized_(ptr->normalized()),
@@ -280,7 +280,7 @@ namespace Sass {
     selector_(ptr->selector()),
     isSyntacticClass_(ptr->isSyntacticClass()),
     isClass_(ptr->isClass())
-  { simple_type(PSEUDO_SEL); }
+  { kind(NodeKind::PseudoSelector); simple_type(PSEUDO_SEL); }
 
   // A pseudo-element is made of two colons (::) followed by the name.
   // The `::` notation is introduced by the current document in order to
@@ -344,12 +344,12 @@ namespace Sass {
   : Selector(pstate),
     Vectorized<ComplexSelectorObj>(s),
     is_optional_(false)
-  { }
+  { kind(NodeKind::SelectorList); }
   SelectorList::SelectorList(const SelectorList* ptr)
     : Selector(ptr),
     Vectorized<ComplexSelectorObj>(*ptr),
     is_optional_(ptr->is_optional_)
-  { }
+  { kind(NodeKind::SelectorList); }
 
   size_t SelectorList::hash() const
   {
@@ -397,6 +397,7 @@ namespace Sass {
     chroots_(false),
     hasPreLineFeed_(false)
   {
+    kind(NodeKind::ComplexSelector);
   }
   ComplexSelector::ComplexSelector(const ComplexSelector* ptr)
   : Selector(ptr),
@@ -404,6 +405,7 @@ namespace Sass {
     chroots_(ptr->chroots()),
     hasPreLineFeed_(ptr->hasPreLineFeed())
   {
+    kind(NodeKind::ComplexSelector);
   }
 
   void ComplexSelector::cloneChildren()
@@ -504,11 +506,12 @@ namespace Sass {
     : SelectorComponent(pstate, postLineBreak),
     combinator_(combinator)
   {
+    kind(NodeKind::SelectorCombinator);
   }
   SelectorCombinator::SelectorCombinator(const SelectorCombinator* ptr)
     : SelectorComponent(ptr->pstate(), false),
       combinator_(ptr->combinator())
-  { }
+  { kind(NodeKind::SelectorCombinator); }
 
   void SelectorCombinator::cloneChildren()
   {
@@ -528,13 +531,14 @@ namespace Sass {
       hasRealParent_(false),
       extended_(false)
   {
+    kind(NodeKind::CompoundSelector);
   }
   CompoundSelector::CompoundSelector(const CompoundSelector* ptr)
     : SelectorComponent(ptr),
       Vectorized<SimpleSelectorObj>(*ptr),
       hasRealParent_(ptr->hasRealParent()),
       extended_(ptr->extended())
-  { }
+  { kind(NodeKind::CompoundSelector); }
 
   size_t CompoundSelector::hash() const
   {
@@ -604,6 +608,7 @@ namespace Sass {
     ParentStatement(pstate, block),
     schema_({})
   {
+    kind(NodeKind::MediaRule);
     statement_type(MEDIA);
   }
 
@@ -611,6 +616,7 @@ namespace Sass {
     ParentStatement(ptr),
     schema_(ptr->schema_)
   {
+    kind(NodeKind::MediaRule);
     statement_type(MEDIA);
   }
 
@@ -621,6 +627,7 @@ namespace Sass {
     ParentStatement(pstate, block),
     Vectorized()
   {
+    kind(NodeKind::CssMediaRule);
     statement_type(MEDIA);
   }
 
@@ -628,6 +635,7 @@ namespace Sass {
     ParentStatement(ptr),
     Vectorized(*ptr)
   {
+    kind(NodeKind::CssMediaRule);
     statement_type(MEDIA);
   }
 
@@ -637,6 +645,7 @@ namespace Sass {
     type_(""),
     features_()
   {
+    kind(NodeKind::CssMediaQuery);
   }
 
   /////////////////////////////////////////////////////////////////////////
@@ -781,11 +790,12 @@ namespace Sass {
   }
 
   CssMediaQuery::CssMediaQuery(const CssMediaQuery* ptr) :
-    AST_Node(*ptr),
+    AST_Node(ptr),
     modifier_(ptr->modifier_),
     type_(ptr->type_),
     features_(ptr->features_)
   {
+    kind(NodeKind::CssMediaQuery);
   }
 
   /////////////////////////////////////////////////////////////////////////
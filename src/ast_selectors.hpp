@@ -4,6 +4,8 @@
 // sass.hpp must go before all system headers to get the
 // __EXTENSIONS__ fix on Solaris.
 #include "sass.hpp"
+
+#include <cstdint>
 #include "ast.hpp"
 
 namespace Sass {
@@ -21,6 +23,24 @@ namespace Sass {
     const sass::vector<SelectorComponentObj>& complex1,
     const sass::vector<SelectorComponentObj>& complex2);
 
+  // Bitsets over the simple selectors of a complex selector. Every simple
+  // selector of a superselector must be matched by one of its subselector,
+  // so most pairs are ruled out without calling `complexIsSuperselector`.
+  struct SuperselectorSignature {
+    // Simple selectors that must be matched in a subselector
+    uint64_t required = 0;
+    // Simple selectors that can match (all for selector pseudos)
+    uint64_t provided = 0;
+    // False if [this] can't be a superselector of [sub]
+    bool mayBeSuperselectorOf(const SuperselectorSignature& sub) const
+    {
+      return (required & ~sub.provided) == 0;
+    }
+  };
+
+  SuperselectorSignature superselectorSignature(
+    const ComplexSelector* complex);
+
     sass::vector<sass::vector<SelectorComponentObj>> weave(
     const sass::vector<sass::vector<SelectorComponentObj>>& complexes);
 
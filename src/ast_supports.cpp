@@ -11,10 +11,10 @@ namespace Sass {
 
   SupportsRule::SupportsRule(SourceSpan pstate, SupportsConditionObj condition, Block_Obj block)
   : ParentStatement(pstate, block), condition_(condition)
-  { statement_type(SUPPORTS); }
+  { kind(NodeKind::SupportsRule); statement_type(SUPPORTS); }
   SupportsRule::SupportsRule(const SupportsRule* ptr)
   : ParentStatement(ptr), condition_(ptr->condition_)
-  { statement_type(SUPPORTS); }
+  { kind(NodeKind::SupportsRule); statement_type(SUPPORTS); }
   bool SupportsRule::bubbles() { return true; }
 
   /////////////////////////////////////////////////////////////////////////
@@ -22,24 +22,24 @@ namespace Sass {
 
   SupportsCondition::SupportsCondition(SourceSpan pstate)
   : Expression(pstate)
-  { }
+  { kind(NodeKind::SupportsCondition); }
 
   SupportsCondition::SupportsCondition(const SupportsCondition* ptr)
   : Expression(ptr)
-  { }
+  { kind(NodeKind::SupportsCondition); }
 
   /////////////////////////////////////////////////////////////////////////
   /////////////////////////////////////////////////////////////////////////
 
   SupportsOperation::SupportsOperation(SourceSpan pstate, SupportsConditionObj l, SupportsConditionObj r, Operand o)
   : SupportsCondition(pstate), left_(l), right_(r), operand_(o)
-  { }
+  { kind(NodeKind::SupportsOperation); }
   SupportsOperation::SupportsOperation(const SupportsOperation* ptr)
   : SupportsCondition(ptr),
     left_(ptr->left_),
     right_(ptr->right_),
     operand_(ptr->operand_)
-  { }
+  { kind(NodeKind::SupportsOperation); }
 
   bool SupportsOperation::needs_parens(SupportsConditionObj cond) const
   {
@@ -54,10 +54,10 @@ namespace Sass {
 
   SupportsNegation::SupportsNegation(SourceSpan pstate, SupportsConditionObj c)
   : SupportsCondition(pstate), condition_(c)
-  { }
+  { kind(NodeKind::SupportsNegation); }
   SupportsNegation::SupportsNegation(const SupportsNegation* ptr)
   : SupportsCondition(ptr), condition_(ptr->condition_)
-  { }
+  { kind(NodeKind::SupportsNegation); }
 
   bool SupportsNegation::needs_parens(SupportsConditionObj cond) const
   {
@@ -70,12 +70,12 @@ namespace Sass {
 
   SupportsDeclaration::SupportsDeclaration(SourceSpan pstate, ExpressionObj f, ExpressionObj v)
   : SupportsCondition(pstate), feature_(f), value_(v)
-  { }
+  { kind(NodeKind::SupportsDeclaration); }
   SupportsDeclaration::SupportsDeclaration(const SupportsDeclaration* ptr)
   : SupportsCondition(ptr),
     feature_(ptr->feature_),
     value_(ptr->value_)
-  { }
+  { kind(NodeKind::SupportsDeclaration); }
 
   bool SupportsDeclaration::needs_parens(SupportsConditionObj cond) const
   {
@@ -87,11 +87,11 @@ namespace Sass {
 
   Supports_Interpolation::Supports_Interpolation(SourceSpan pstate, ExpressionObj v)
   : SupportsCondition(pstate), value_(v)
-  { }
+  { kind(NodeKind::Supports_Interpolation); }
   Supports_Interpolation::Supports_Interpolation(const Supports_Interpolation* ptr)
   : SupportsCondition(ptr),
     value_(ptr->value_)
-  { }
+  { kind(NodeKind::Supports_Interpolation); }
 
   bool Supports_Interpolation::needs_parens(SupportsConditionObj cond) const
   {
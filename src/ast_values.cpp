@@ -35,21 +35,21 @@ namespace Sass {
 
   List::List(SourceSpan pstate, size_t size, enum Sass_Separator sep, bool argl, bool bracket)
   : Value(pstate),
-    Vectorized<ExpressionObj>(size),
+    Vectorized<ExpressionObj, shared_vector<ExpressionObj>>(size),
     separator_(sep),
     is_arglist_(argl),
     is_bracketed_(bracket),
     from_selector_(false)
-  { concrete_type(LIST); }
+  { kind(NodeKind::List); concrete_type(LIST); }
 
   List::List(const List* ptr)
   : Value(ptr),
-    Vectorized<ExpressionObj>(*ptr),
+    Vectorized<ExpressionObj, shared_vector<ExpressionObj>>(*ptr),
     separator_(ptr->separator_),
     is_arglist_(ptr->is_arglist_),
     is_bracketed_(ptr->is_bracketed_),
     from_selector_(ptr->from_selector_)
-  { concrete_type(LIST); }
+  { kind(NodeKind::List); concrete_type(LIST); }
 
   size_t List::hash() const
   {
@@ -137,12 +137,12 @@ namespace Sass {
   Map::Map(SourceSpan pstate, size_t size)
   : Value(pstate),
     Hashed(size)
-  { concrete_type(MAP); }
+  { kind(NodeKind::Map); concrete_type(MAP); }
 
   Map::Map(const Map* ptr)
   : Value(ptr),
     Hashed(*ptr)
-  { concrete_type(MAP); }
+  { kind(NodeKind::Map); concrete_type(MAP); }
 
   bool Map::operator< (const Expression& rhs) const
   {
@@ -216,7 +216,7 @@ namespace Sass {
   Binary_Expression::Binary_Expression(SourceSpan pstate,
                     Operand op, ExpressionObj lhs, ExpressionObj rhs)
   : PreValue(pstate), op_(op), left_(lhs), right_(rhs), hash_(0)
-  { }
+  { kind(NodeKind::Binary_Expression); }
 
   Binary_Expression::Binary_Expression(const Binary_Expression* ptr)
   : PreValue(ptr),
@@ -224,7 +224,7 @@ namespace Sass {
     left_(ptr->left_),
     right_(ptr->right_),
     hash_(ptr->hash_)
-  { }
+  { kind(NodeKind::Binary_Expression); }
 
   bool Binary_Expression::is_left_interpolant(void) const
   {
@@ -294,11 +294,11 @@ namespace Sass {
 
   Function::Function(SourceSpan pstate, Definition_Obj def, bool css)
   : Value(pstate), definition_(def), is_css_(css)
-  { concrete_type(FUNCTION_VAL); }
+  { kind(NodeKind::Function); concrete_type(FUNCTION_VAL); }
 
   Function::Function(const Function* ptr)
   : Value(ptr), definition_(ptr->definition_), is_css_(ptr->is_css_)
-  { concrete_type(FUNCTION_VAL); }
+  { kind(NodeKind::Function); concrete_type(FUNCTION_VAL); }
 
   bool Function::operator< (const Expression& rhs) const
   {
@@ -337,34 +337,60 @@ namespace Sass {
   /////////////////////////////////////////////////////////////////////////
 
   Function_Call::Function_Call(SourceSpan pstate, String_Obj n, Arguments_Obj args, void* cookie)
-  : PreValue(pstate), sname_(n), arguments_(args), func_(), via_call_(false), cookie_(cookie), hash_(0)
-  { concrete_type(FUNCTION); }
+  : PreValue(pstate), arguments_(args), func_(), via_call_(false), cookie_(cookie), hash_(0)
+  { kind(NodeKind::Function_Call); concrete_type(FUNCTION); sname(n); }
   Function_Call::Function_Call(SourceSpan pstate, String_Obj n, Arguments_Obj args, Function_Obj func)
-  : PreValue(pstate), sname_(n), arguments_(args), func_(func), via_call_(false), cookie_(0), hash_(0)
-  { concrete_type(FUNCTION); }
+  : PreValue(pstate), arguments_(args), func_(func), via_call_(false), cookie_(0), hash_(0)
+  { kind(NodeKind::Function_Call); concrete_type(FUNCTION); sname(n); }
   Function_Call::Function_Call(SourceSpan pstate, String_Obj n, Arguments_Obj args)
-  : PreValue(pstate), sname_(n), arguments_(args), via_call_(false), cookie_(0), hash_(0)
-  { concrete_type(FUNCTION); }
+  : PreValue(pstate), arguments_(args), via_call_(false), cookie_(0), hash_(0)
+  { kind(NodeKind::Function_Call); concrete_type(FUNCTION); sname(n); }
 
   Function_Call::Function_Call(SourceSpan pstate, sass::string n, Arguments_Obj args, void* cookie)
-  : PreValue(pstate), sname_(SASS_MEMORY_NEW(String_Constant, pstate, n)), arguments_(args), func_(), via_call_(false), cookie_(cookie), hash_(0)
-  { concrete_type(FUNCTION); }
+  : PreValue(pstate), arguments_(args), func_(), via_call_(false), cookie_(cookie), hash_(0)
+  { kind(NodeKind::Function_Call); concrete_type(FUNCTION); sname(SASS_MEMORY_NEW(String_Constant, pstate, n)); }
   Function_Call::Function_Call(SourceSpan pstate, sass::string n, Arguments_Obj args, Function_Obj func)
-  : PreValue(pstate), sname_(SASS_MEMORY_NEW(String_Constant, pstate, n)), arguments_(args), func_(func), via_call_(false), cookie_(0), hash_(0)
-  { concrete_type(FUNCTION); }
+  : PreValue(pstate), arguments_(args), func_(func), via_call_(false), cookie_(0), hash_(0)
+  { kind(NodeKind::Function_Call); concrete_type(FUNCTION); sname(SASS_MEMORY_NEW(String_Constant, pstate, n)); }
   Function_Call::Function_Call(SourceSpan pstate, sass::string n, Arguments_Obj args)
-  : PreValue(pstate), sname_(SASS_MEMORY_NEW(String_Constant, pstate, n)), arguments_(args), via_call_(false), cookie_(0), hash_(0)
-  { concrete_type(FUNCTION); }
+  : PreValue(pstate), arguments_(args), via_call_(false), cookie_(0), hash_(0)
+  { kind(NodeKind::Function_Call); concrete_type(FUNCTION); sname(SASS_MEMORY_NEW(String_Constant, pstate, n)); }
 
   Function_Call::Function_Call(const Function_Call* ptr)
   : PreValue(ptr),
-    sname_(ptr->sname_),
     arguments_(ptr->arguments_),
     func_(ptr->func_),
     via_call_(ptr->via_call_),
     cookie_(ptr->cookie_),
-    hash_(ptr->hash_)
-  { concrete_type(FUNCTION); }
+    hash_(ptr->hash_),
+    sname_(ptr->sname_),
+    lookup_(ptr->lookup_)
+  { kind(NodeKind::Function_Call); concrete_type(FUNCTION); }
+
+  // Interning takes a lock, so we do it once per node
+  // instead of every time the function is called
+  void Function_Call::sname(String_Obj sname, bool intern)
+  {
+    hash_ = 0;
+    sname_ = sname;
+    if (sname_ && !Cast<String_Schema>(sname_)) {
+      sass::string key(Util::normalize_underscores(sname_->to_string()) + "[f]");
+      lookup_ = intern ? Symbol(key) : Symbol::find(key);
+    }
+    else {
+      lookup_ = Symbol();
+    }
+  }
+
+  const Symbol& Function_Call::overload(size_t arity) const
+  {
+    if (overload_arity_ != arity) {
+      overload_ = lookup_.empty() ? lookup_
+        : Symbol::find(lookup_.str() + std::to_string(arity));
+      overload_arity_ = arity;
+    }
+    return overload_;
+  }
 
   bool Function_Call::operator==(const Expression& rhs) const
   {
@@ -402,12 +428,12 @@ namespace Sass {
   /////////////////////////////////////////////////////////////////////////
 
   Variable::Variable(SourceSpan pstate, sass::string n)
-  : PreValue(pstate), name_(n)
-  { concrete_type(VARIABLE); }
+  : PreValue(pstate), symbol_(n), slot_(sass::string::npos)
+  { kind(NodeKind::Variable); concrete_type(VARIABLE); }
 
   Variable::Variable(const Variable* ptr)
-  : PreValue(ptr), name_(ptr->name_)
-  { concrete_type(VARIABLE); }
+  : PreValue(ptr), symbol_(ptr->symbol_), slot_(ptr->slot_)
+  { kind(NodeKind::Variable); concrete_type(VARIABLE); }
 
   bool Variable::operator==(const Expression& rhs) const
   {
@@ -419,7 +445,7 @@ namespace Sass {
 
   size_t Variable::hash() const
   {
-    return std::hash<sass::string>()(name());
+    return symbol_.hash();
   }
 
   /////////////////////////////////////////////////////////////////////////
@@ -432,6 +458,7 @@ namespace Sass {
     zero_(zero),
     hash_(0)
   {
+    kind(NodeKind::Number);
     size_t l = 0;
     size_t r;
     if (!u.empty()) {
@@ -440,8 +467,9 @@ namespace Sass {
         r = u.find_first_of("*/", l);
         sass::string unit(u.substr(l, r == sass::string::npos ? r : r - l));
         if (!unit.empty()) {
-          if (nominator) numerators.push_back(unit);
-          else denominators.push_back(unit);
+          Unit parsed(unit);
+          if (nominator) numerators.push_back(parsed);
+          else denominators.push_back(parsed);
         }
         if (r == sass::string::npos) break;
         // ToDo: should error for multiple slashes
@@ -462,7 +490,7 @@ namespace Sass {
     Units(ptr),
     value_(ptr->value_), zero_(ptr->zero_),
     hash_(ptr->hash_)
-  { concrete_type(NUMBER); }
+  { kind(NodeKind::Number); concrete_type(NUMBER); }
 
   // cancel out unnecessary units
   void Number::reduce()
@@ -481,10 +509,10 @@ namespace Sass {
   {
     if (hash_ == 0) {
       hash_ = std::hash<double>()(value_);
-      for (const auto numerator : numerators)
-        hash_combine(hash_, std::hash<sass::string>()(numerator));
-      for (const auto denominator : denominators)
-        hash_combine(hash_, std::hash<sass::string>()(denominator));
+      for (const Unit& numerator : numerators)
+        hash_combine(hash_, numerator.hash());
+      for (const Unit& denominator : denominators)
+        hash_combine(hash_, denominator.hash());
     }
     return hash_;
   }
@@ -598,14 +626,14 @@ namespace Sass {
   Color_RGBA::Color_RGBA(SourceSpan pstate, double r, double g, double b, double a, const sass::string disp)
   : Color(pstate, a, disp),
     r_(r), g_(g), b_(b)
-  { concrete_type(COLOR); }
+  { kind(NodeKind::Color_RGBA); concrete_type(COLOR); }
 
   Color_RGBA::Color_RGBA(const Color_RGBA* ptr)
   : Color(ptr),
     r_(ptr->r_),
     g_(ptr->g_),
     b_(ptr->b_)
-  { concrete_type(COLOR); }
+  { kind(NodeKind::Color_RGBA); concrete_type(COLOR); }
 
   bool Color_RGBA::operator< (const Expression& rhs) const
   {
@@ -699,7 +727,7 @@ namespace Sass {
     s_(clip(s, 0.0, 100.0)),
     l_(clip(l, 0.0, 100.0))
     // hash_(0)
-  { concrete_type(COLOR); }
+  { kind(NodeKind::Color_HSLA); concrete_type(COLOR); }
 
   Color_HSLA::Color_HSLA(const Color_HSLA* ptr)
   : Color(ptr),
@@ -707,7 +735,7 @@ namespace Sass {
     s_(ptr->s_),
     l_(ptr->l_)
     // hash_(ptr->hash_)
-  { concrete_type(COLOR); }
+  { kind(NodeKind::Color_HSLA); concrete_type(COLOR); }
 
   bool Color_HSLA::operator< (const Expression& rhs) const
   {
@@ -791,11 +819,11 @@ namespace Sass {
 
   Custom_Error::Custom_Error(SourceSpan pstate, sass::string msg)
   : Value(pstate), message_(msg)
-  { concrete_type(C_ERROR); }
+  { kind(NodeKind::Custom_Error); concrete_type(C_ERROR); }
 
   Custom_Error::Custom_Error(const Custom_Error* ptr)
   : Value(ptr), message_(ptr->message_)
-  { concrete_type(C_ERROR); }
+  { kind(NodeKind::Custom_Error); concrete_type(C_ERROR); }
 
   bool Custom_Error::operator< (const Expression& rhs) const
   {
@@ -819,11 +847,11 @@ namespace Sass {
 
   Custom_Warning::Custom_Warning(SourceSpan pstate, sass::string msg)
   : Value(pstate), message_(msg)
-  { concrete_type(C_WARNING); }
+  { kind(NodeKind::Custom_Warning); concrete_type(C_WARNING); }
 
   Custom_Warning::Custom_Warning(const Custom_Warning* ptr)
   : Value(ptr), message_(ptr->message_)
-  { concrete_type(C_WARNING); }
+  { kind(NodeKind::Custom_Warning); concrete_type(C_WARNING); }
 
   bool Custom_Warning::operator< (const Expression& rhs) const
   {
@@ -848,13 +876,13 @@ namespace Sass {
   Boolean::Boolean(SourceSpan pstate, bool val)
   : Value(pstate), value_(val),
     hash_(0)
-  { concrete_type(BOOLEAN); }
+  { kind(NodeKind::Boolean); concrete_type(BOOLEAN); }
 
   Boolean::Boolean(const Boolean* ptr)
   : Value(ptr),
     value_(ptr->value_),
     hash_(ptr->hash_)
-  { concrete_type(BOOLEAN); }
+  { kind(NodeKind::Boolean); concrete_type(BOOLEAN); }
 
  bool Boolean::operator< (const Expression& rhs) const
   {
@@ -895,14 +923,14 @@ namespace Sass {
 
   String_Schema::String_Schema(SourceSpan pstate, size_t size, bool css)
   : String(pstate), Vectorized<PreValueObj>(size), css_(css), hash_(0)
-  { concrete_type(STRING); }
+  { kind(NodeKind::String_Schema); concrete_type(STRING); }
 
   String_Schema::String_Schema(const String_Schema* ptr)
   : String(ptr),
     Vectorized<PreValueObj>(*ptr),
     css_(ptr->css_),
     hash_(ptr->hash_)
-  { concrete_type(STRING); }
+  { kind(NodeKind::String_Schema); concrete_type(STRING); }
 
   void String_Schema::rtrim()
   {
@@ -978,23 +1006,23 @@ namespace Sass {
 
   String_Constant::String_Constant(SourceSpan pstate, sass::string val, bool css)
   : String(pstate), quote_mark_(0), value_(read_css_string(val, css)), hash_(0)
-  { }
+  { kind(NodeKind::String_Constant); }
   String_Constant::String_Constant(SourceSpan pstate, const char* beg, bool css)
   : String(pstate), quote_mark_(0), value_(read_css_string(sass::string(beg), css)), hash_(0)
-  { }
+  { kind(NodeKind::String_Constant); }
   String_Constant::String_Constant(SourceSpan pstate, const char* beg, const char* end, bool css)
   : String(pstate), quote_mark_(0), value_(read_css_string(sass::string(beg, end-beg), css)), hash_(0)
-  { }
+  { kind(NodeKind::String_Constant); }
   String_Constant::String_Constant(SourceSpan pstate, const Token& tok, bool css)
   : String(pstate), quote_mark_(0), value_(read_css_string(sass::string(tok.begin, tok.end), css)), hash_(0)
-  { }
+  { kind(NodeKind::String_Constant); }
 
   String_Constant::String_Constant(const String_Constant* ptr)
   : String(ptr),
     quote_mark_(ptr->quote_mark_),
     value_(ptr->value_),
     hash_(ptr->hash_)
-  { }
+  { kind(NodeKind::String_Constant); }
 
   bool String_Constant::is_invisible() const {
     return value_.empty() && quote_mark_ == 0;
@@ -1049,6 +1077,7 @@ namespace Sass {
     bool strict_unquoting, bool css)
   : String_Constant(pstate, val, css)
   {
+    kind(NodeKind::String_Quoted);
     if (skip_unquoting == false) {
       value_ = unquote(value_, &quote_mark_, keep_utf8_escapes, strict_unquoting);
     }
@@ -1057,7 +1086,7 @@ namespace Sass {
 
   String_Quoted::String_Quoted(const String_Quoted* ptr)
   : String_Constant(ptr)
-  { }
+  { kind(NodeKind::String_Quoted); }
 
   bool String_Quoted::operator< (const Expression& rhs) const
   {
@@ -1092,10 +1121,10 @@ namespace Sass {
 
   Null::Null(SourceSpan pstate)
   : Value(pstate)
-  { concrete_type(NULL_VAL); }
+  { kind(NodeKind::Null); concrete_type(NULL_VAL); }
 
   Null::Null(const Null* ptr) : Value(ptr)
-  { concrete_type(NULL_VAL); }
+  { kind(NodeKind::Null); concrete_type(NULL_VAL); }
 
   bool Null::operator< (const Expression& rhs) const
   {
@@ -1121,11 +1150,11 @@ namespace Sass {
 
   Parent_Reference::Parent_Reference(SourceSpan pstate)
   : Value(pstate)
-  { concrete_type(PARENT); }
+  { kind(NodeKind::Parent_Reference); concrete_type(PARENT); }
 
   Parent_Reference::Parent_Reference(const Parent_Reference* ptr)
   : Value(ptr)
-  { concrete_type(PARENT); }
+  { kind(NodeKind::Parent_Reference); concrete_type(PARENT); }
 
   /////////////////////////////////////////////////////////////////////////
   /////////////////////////////////////////////////////////////////////////
@@ -5,6 +5,7 @@
 // __EXTENSIONS__ fix on Solaris.
 #include "sass.hpp"
 #include "ast.hpp"
+#include "shared_vector.hpp"
 
 namespace Sass {
 
@@ -46,8 +47,9 @@ namespace Sass {
   ///////////////////////////////////////////////////////////////////////
   // Lists of values, both comma- and space-separated (distinguished by a
   // type-tag.) Also used to represent variable-length argument lists.
+  // Copies share the elements until they are changed (see `append`).
   ///////////////////////////////////////////////////////////////////////
-  class List : public Value, public Vectorized<ExpressionObj> {
+  class List : public Value, public Vectorized<ExpressionObj, shared_vector<ExpressionObj>> {
     void adjust_after_pushing(ExpressionObj e) override { is_expanded(false); }
   private:
     ADD_PROPERTY(enum Sass_Separator, separator)
@@ -157,13 +159,30 @@ namespace Sass {
   // Function calls.
   //////////////////
   class Function_Call final : public PreValue {
-    HASH_CONSTREF(String_Obj, sname)
     HASH_PROPERTY(Arguments_Obj, arguments)
     HASH_PROPERTY(Function_Obj, func)
     ADD_PROPERTY(bool, via_call)
     ADD_PROPERTY(void*, cookie)
     mutable size_t hash_;
+  protected:
+    String_Obj sname_;
+    // environment key of the function, set
+    // together with the name (empty if the
+    // name is interpolated)
+    Symbol lookup_;
+    // key of the overload for the last number of
+    // arguments, so calls in loops don't take the
+    // lock of the symbol table every time
+    mutable Symbol overload_;
+    mutable size_t overload_arity_ = sass::string::npos;
   public:
+    const String_Obj& sname() const { return sname_; }
+    // names only known at runtime are not interned
+    void sname(String_Obj sname, bool intern = true);
+    const Symbol& lookup() const { return lookup_; }
+    // environment key of the overload taking [arity] arguments,
+    // never interned (empty if there is no such overload)
+    const Symbol& overload(size_t arity) const;
     Function_Call(SourceSpan pstate, sass::string n, Arguments_Obj args, void* cookie);
     Function_Call(SourceSpan pstate, sass::string n, Arguments_Obj args, Function_Obj func);
     Function_Call(SourceSpan pstate, sass::string n, Arguments_Obj args);
@@ -187,9 +206,14 @@ namespace Sass {
   // Variable references.
   ///////////////////////
   class Variable final : public PreValue {
-    ADD_CONSTREF(sass::string, name)
+    // interned name, used for lookups
+    ADD_CONSTREF(Symbol, symbol)
+    // frame slot where the name was last found
+    ADD_PROPERTY(size_t, slot)
   public:
     Variable(SourceSpan pstate, sass::string n);
+    const sass::string& name() const { return symbol_.str(); }
+    void name(const sass::string& name) { symbol_ = name; }
     virtual bool operator==(const Expression& rhs) const override;
     virtual size_t hash() const override;
     ATTACH_AST_OPERATIONS(Variable)
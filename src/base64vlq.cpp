@@ -37,7 +37,7 @@ namespace Sass {
     return (number < 0) ? ((-number) << 1) + 1 : (number << 1) + 0;
   }
 
-  const char* Base64VLQ::CHARACTERS = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  const char* const Base64VLQ::CHARACTERS = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
 
   const int Base64VLQ::VLQ_BASE_SHIFT = 5;
   const int Base64VLQ::VLQ_BASE = 1 << VLQ_BASE_SHIFT;
@@ -17,7 +17,7 @@ namespace Sass {
 
     int to_vlq_signed(const int number) const;
 
-    static const char* CHARACTERS;
+    static const char* const CHARACTERS;
 
     static const int VLQ_BASE_SHIFT;
     static const int VLQ_BASE;
@@ -3,6 +3,7 @@
 
 #include "position.hpp"
 #include "backtrace.hpp"
+#include "units.hpp"
 #include "ast_fwd_decl.hpp"
 
 namespace Sass {
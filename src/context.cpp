@@ -3,6 +3,9 @@
 #include "sass.hpp"
 #include "ast.hpp"
 
+#include <algorithm>
+#include <cstring>
+
 #include "remove_placeholders.hpp"
 #include "sass_functions.hpp"
 #include "check_nesting.hpp"
@@ -16,6 +19,7 @@
 #include "context.hpp"
 #include "expand.hpp"
 #include "parser.hpp"
+#include "serializer.hpp"
 #include "cssize.hpp"
 
 namespace Sass {
@@ -41,6 +45,16 @@ namespace Sass {
     return out_path;
   }
 
+  size_t ParsedTextHash::operator()(const ParsedText& key) const
+  {
+    size_t hash = std::hash<sass::string>()(key.text);
+    hash_combine(hash, key.path);
+    hash_combine(hash, key.position.file);
+    hash_combine(hash, key.position.line);
+    hash_combine(hash, key.position.column);
+    return hash;
+  }
+
   Context::Context(struct Sass_Context& c_ctx)
   : CWD(File::get_cwd()),
     c_options(c_ctx),
@@ -49,8 +63,14 @@ namespace Sass {
     plugins(),
     emitter(c_options),
 
-    ast_gc(),
+    #ifdef SASS_ARENA_ALLOCATOR
+    arena(Memory::Arena::create()),
+    #else
+    arena(nullptr),
+    #endif
     strings(),
+    parsed_selectors(),
+    parsed_media_queries(),
     resources(),
     sheets(),
     import_stack(),
@@ -58,6 +78,7 @@ namespace Sass {
     traces(),
     extender(Extender::NORMAL, traces),
     c_compiler(NULL),
+    dir_index(c_options.directory_index, CWD),
 
     c_headers               (sass::vector<Sass_Importer_Entry>()),
     c_importers             (sass::vector<Sass_Importer_Entry>()),
@@ -116,9 +137,9 @@ namespace Sass {
 
   Context::~Context()
   {
-    // resources were allocated by malloc
+    // resources were allocated by malloc (or mapped)
     for (size_t i = 0; i < resources.size(); ++i) {
-      free(resources[i].contents);
+      free_file(resources[i].contents, resources[i].mapped);
       free(resources[i].srcmap);
     }
     // free all strings we kept alive during compiler execution
@@ -133,6 +154,10 @@ namespace Sass {
     // clear inner structures (vectors) and input source
     resources.clear(); import_stack.clear();
     sheets.clear();
+    #ifdef SASS_ARENA_ALLOCATOR
+    // arena is freed once all nodes are gone
+    arena->release();
+    #endif
   }
 
   Data_Context::~Data_Context()
@@ -221,12 +246,12 @@ namespace Sass {
     // make sure we resolve against an absolute path
     sass::string base_path(rel2abs(import.base_path));
     // first try to resolve the load path relative to the base path
-    sass::vector<Include> vec(resolve_includes(base_path, import.imp_path));
+    sass::vector<Include> vec(resolve_includes(base_path, import.imp_path, defaultExtensions, &dir_index));
     // then search in every include path (but only if nothing found yet)
     for (size_t i = 0, S = include_paths.size(); vec.size() == 0 && i < S; ++i)
     {
       // call resolve_includes and individual base path and append all results
-      sass::vector<Include> resolved(resolve_includes(include_paths[i], import.imp_path));
+      sass::vector<Include> resolved(resolve_includes(include_paths[i], import.imp_path, defaultExtensions, &dir_index));
       if (resolved.size()) vec.insert(vec.end(), resolved.begin(), resolved.end());
     }
     // return vector
@@ -297,13 +322,14 @@ namespace Sass {
       }
     }
 
-    // create a parser instance from the given c_str buffer
-    Parser p(Parser::from_c_str(contents, *this, traces, pstate));
     // do not yet dispose these buffers
     sass_import_take_source(import);
     sass_import_take_srcmap(import);
-    // then parse the root block
-    Block_Obj root = p.parse();
+
+    Block_Obj root;
+    if (use_sheet_cache(idx)) root = load_cached_sheet(contents, pstate);
+    else root = parse_sheet(contents, pstate);
+
     // delete memory of current stack frame
     sass_delete_import(import_stack.back());
     // remove current stack frame
@@ -315,6 +341,96 @@ namespace Sass {
     sheets.insert(ast_pair);
   }
 
+  // Trees are shared through the stylesheet cache of the process. Custom
+  // importers may load other files for the imports of a cached tree (we
+  // resolve them again on the file system), so they turn the cache off.
+  // Custom headers are only added to the tree of the entry stylesheet.
+  bool Context::use_sheet_cache(size_t idx) const
+  {
+    return c_options.stylesheet_cache && c_importers.empty()
+      && resources[idx].from_file && (idx > 0 || c_headers.empty());
+  }
+
+  // Loads the tree from the stylesheet cache (or its directory) if it was
+  // stored for the current source, otherwise parses it and stores the tree.
+  // The modification time of the file is taken after reading it, so a file
+  // changed in the meantime is parsed again by the next compilation.
+  Block_Obj Context::load_cached_sheet(const char* contents, SourceSpan& pstate)
+  {
+    const sass::string path(pstate.path);
+    int64_t mtime = 0;
+    if (!File::modification_time(path, mtime)) return parse_sheet(contents, pstate);
+    const char* dir = c_options.stylesheet_cache_path;
+    StyleSheetCache::Data data(StyleSheetCache::find(path, mtime));
+    bool found = data != nullptr;
+    if (!found && dir && *dir) {
+      sass::string stored;
+      if (read_precompiled(StyleSheetCache::stored_path(dir, path), stored)) {
+        data = std::make_shared<const sass::string>(std::move(stored));
+      }
+    }
+    if (data) {
+      try {
+        Deserializer deserializer(*this, *data, pstate);
+        if (Block_Obj root = deserializer.read_root()) {
+          if (!found) StyleSheetCache::insert(path, mtime, data);
+          return root;
+        }
+      }
+      // damaged, parse it instead
+      catch (SerializationError&) {}
+    }
+    Block_Obj root = parse_sheet(contents, pstate);
+    try {
+      Serializer serializer(contents);
+      serializer.write(root);
+      data = std::make_shared<const sass::string>(serializer.data());
+    }
+    // trees we can't store are parsed every time
+    catch (SerializationError&) { return root; }
+    StyleSheetCache::insert(path, mtime, data);
+    if (dir && *dir) write_precompiled(StyleSheetCache::stored_path(dir, path), *data);
+    return root;
+  }
+
+  // Mapped files raise SIGBUS if they are truncated while
+  // we still use them, so mapping is left to the caller
+  char* Context::read_resource(const sass::string& path, size_t& mapped) const
+  {
+    mapped = 0;
+    if (c_options.map_files) return read_file(path, mapped);
+    return read_file(path);
+  }
+
+  // Precompiled trees are stored next to the source, so we
+  // can't use them if anything but the file system is involved
+  bool Context::use_precompiled() const
+  {
+    return c_options.load_precompiled
+      && c_headers.empty() && c_importers.empty();
+  }
+
+  // Loads the tree from the sidecar of the stylesheet (if there
+  // is one for the current source) or parses the given contents
+  Block_Obj Context::parse_sheet(const char* contents, SourceSpan& pstate)
+  {
+    sass::string data;
+    // only files can have a sidecar
+    if (use_precompiled() && resources[pstate.file].from_file &&
+        read_precompiled(precompiled_path(pstate.path), data)) {
+      try {
+        Deserializer deserializer(*this, data, pstate);
+        if (Block_Obj root = deserializer.read_root()) return root;
+      }
+      // parse the source instead
+      catch (SerializationError&) {}
+    }
+    // create a parser instance from the given c_str buffer
+    Parser p(Parser::from_c_str(contents, *this, traces, pstate));
+    // then parse the root block
+    return p.parse();
+  }
+
   // register include with resolved path and its content
   // memory of the resources will be freed by us on exit
   void Context::register_resource(const Include& inc, const Resource& res, SourceSpan& prstate)
@@ -330,7 +446,7 @@ namespace Sass {
 
     // search for valid imports (ie. partials) on the filesystem
     // this may return more than one valid result (ambiguous imp_path)
-    const sass::vector<Include> resolved(find_includes(imp));
+    sass::vector<Include> resolved(find_includes(imp));
 
     // error nicely on ambiguous imp_path
     if (resolved.size() > 1) {
@@ -346,14 +462,19 @@ namespace Sass {
 
     // process the resolved entry
     else if (resolved.size() == 1) {
+      // serialized trees resolve it again from there
+      resolved[0].load_path = imp.imp_path;
       bool use_cache = c_importers.size() == 0;
       // use cache for the resource loading
-      if (use_cache && sheets.count(resolved[0].abs_path)) return resolved[0];
+      if (use_cache && sheets.count(resolved[0].abs_path)) {
+        return resolved[0];
+      }
       // try to read the content of the resolved file entry
       // the memory buffer returned must be freed by us!
-      if (char* contents = read_file(resolved[0].abs_path)) {
+      size_t mapped = 0;
+      if (char* contents = read_resource(resolved[0].abs_path, mapped)) {
         // register the newly resolved file resource
-        register_resource(resolved[0], { contents, 0 }, pstate);
+        register_resource(resolved[0], { contents, 0, mapped, true }, pstate);
         // return resolved entry
         return resolved[0];
       }
@@ -486,6 +607,7 @@ namespace Sass {
   void register_function(Context&, Signature sig, Native_Function f, size_t arity, Env* env);
   void register_overload_stub(Context&, sass::string name, Env* env);
   void register_built_in_functions(Context&, Env* env);
+  Env* built_in_functions(Context&);
   void register_c_functions(Context&, Env* env, Sass_Function_List);
   void register_c_function(Context&, Env* env, Sass_Function_Entry);
 
@@ -493,28 +615,46 @@ namespace Sass {
   {
     // check for valid block
     if (!root) return 0;
+    // stream the body to the writer if one is set
+    if (c_options.output_writer) {
+      emitter.set_writer(c_options.output_writer, c_options.output_writer_cookie);
+    }
     // start the render process
     root->perform(&emitter);
     // finish emitter stream
     emitter.finalize();
     // get the resulting buffer from stream
-    OutputBuffer emitted = emitter.get_buffer();
+    sass::string& emitted = emitter.get_buffer().buffer;
+    // hoisted charset, imports and comments
+    const sass::string& preamble = emitter.get_preamble();
     // should we append a source map url?
     if (!c_options.omit_source_map_url) {
       // generate an embedded source map
       if (c_options.source_map_embed) {
-        emitted.buffer += linefeed;
-        emitted.buffer += format_embedded_source_map();
+        emitted += linefeed;
+        emitted += format_embedded_source_map();
       }
       // or just link the generated one
       else if (source_map_file != "") {
-        emitted.buffer += linefeed;
-        emitted.buffer += format_source_mapping_url(source_map_file);
+        emitted += linefeed;
+        emitted += format_source_mapping_url(source_map_file);
       }
     }
+    // the body was streamed while emitted, pass on the rest
+    // and the preamble, the output string is null then
+    if (c_options.output_writer) {
+      emitter.flush_writer();
+      emitter.write_output(preamble.data(), preamble.size(), SASS_OUTPUT_PREAMBLE);
+      return 0;
+    }
     // create a copy of the resulting buffer string
     // this must be freed or taken over by implementor
-    return sass_copy_c_string(emitted.buffer.c_str());
+    size_t size = preamble.size() + emitted.size();
+    char* output = (char*) sass_alloc_memory(size + 1);
+    std::memcpy(output, preamble.data(), preamble.size());
+    std::memcpy(output + preamble.size(), emitted.data(), emitted.size());
+    output[size] = '\0';
+    return output;
   }
 
   void Context::apply_custom_headers(Block_Obj root, const char* ctx_path, SourceSpan pstate)
@@ -535,17 +675,40 @@ namespace Sass {
   }
 
   Block_Obj File_Context::parse()
+  {
+    // abort if there is no entry file
+    if (!load_entry()) return {};
+    // create root ast tree node
+    return compile();
+  }
+
+  // parse the entry file and store the tree next to it
+  void File_Context::precompile()
+  {
+    // abort if there is no entry file
+    if (!load_entry()) return;
+    const StyleSheet& sheet = sheets.at(entry_path);
+    Serializer serializer(sheet.contents);
+    serializer.write(sheet.root);
+    sass::string path(precompiled_path(entry_path));
+    if (!write_precompiled(path, serializer.data())) {
+      throw std::runtime_error("File to write not writable: " + path);
+    }
+  }
+
+  bool File_Context::load_entry()
   {
 
     // check if entry file is given
-    if (input_path.empty()) return {};
+    if (input_path.empty()) return false;
 
     // create absolute path from input filename
     // ToDo: this should be resolved via custom importers
     sass::string abs_path(rel2abs(input_path, CWD));
 
     // try to load the entry file
-    char* contents = read_file(abs_path);
+    size_t mapped = 0;
+    char* contents = read_resource(abs_path, mapped);
 
     // alternatively also look inside each include path folder
     // I think this differs from ruby sass (IMO too late to remove)
@@ -553,7 +716,7 @@ namespace Sass {
       // build absolute path for this include path entry
       abs_path = rel2abs(input_path, include_paths[i]);
       // try to load the resulting path
-      contents = read_file(abs_path);
+      contents = read_resource(abs_path, mapped);
     }
 
     // abort early if no content could be loaded (various reasons)
@@ -573,10 +736,9 @@ namespace Sass {
     import_stack.push_back(import);
 
     // create the source entry for file entry
-    register_resource({{ input_path, "." }, abs_path }, { contents, 0 });
+    register_resource({{ input_path, "." }, abs_path }, { contents, 0, mapped, true });
 
-    // create root ast tree node
-    return compile();
+    return true;
 
   }
 
@@ -630,9 +792,9 @@ namespace Sass {
     Block_Obj root = sheets.at(entry_path).root;
     // abort on invalid root
     if (root.isNull()) return {};
-    Env global; // create root environment
-    // register built-in functions on env
-    register_built_in_functions(*this, &global);
+    // create root environment on top of the
+    // built-in functions shared by all contexts
+    Env global(built_in_functions(*this));
     // register custom functions (defined via C-API)
     for (size_t i = 0, S = c_functions.size(); i < S; ++i)
     { register_c_function(*this, &global, c_functions[i]); }
@@ -714,7 +876,7 @@ namespace Sass {
   {
     Definition* def = make_native_function(sig, f, ctx);
     def->environment(env);
-    (*env)[def->name() + "[f]"] = def;
+    env->set_local(def->name() + "[f]", def);
   }
 
   void register_function(Context& ctx, Signature sig, Native_Function f, size_t arity, Env* env)
@@ -723,7 +885,7 @@ namespace Sass {
     sass::sstream ss;
     ss << def->name() << "[f]" << arity;
     def->environment(env);
-    (*env)[ss.str()] = def;
+    env->set_local(ss.str(), def);
   }
 
   void register_overload_stub(Context& ctx, sass::string name, Env* env)
@@ -735,7 +897,57 @@ namespace Sass {
                                        {},
                                        0,
                                        true);
-    (*env)[name + "[f]"] = stub;
+    env->set_local(name + "[f]", stub);
+  }
+
+  // Mark a default value and all its children as immortal
+  static void make_immortal(Expression* value)
+  {
+    if (value == nullptr) return;
+    value->makeImmortal();
+    if (List* list = Cast<List>(value)) {
+      for (Expression* item : list->elements()) {
+        make_immortal(item);
+      }
+    }
+    else if (Unary_Expression* unary = Cast<Unary_Expression>(value)) {
+      make_immortal(unary->operand());
+    }
+  }
+
+  // The built-in functions never change, so we only create them once
+  // and share them between all contexts (and threads). All nodes are
+  // allocated on the heap and marked immortal, so no reference counter
+  // is ever touched once they are published. The frame itself is frozen.
+  Env* built_in_functions(Context& ctx)
+  {
+    static Env* const env = [&ctx]() {
+      Memory::ArenaScope scope(nullptr);
+      #ifdef DEBUG_SHARED_PTR
+      // these are not leaked
+      SharedObj::setTaint(false);
+      #endif
+      Env* env = new Env();
+      register_built_in_functions(ctx, env);
+      for (auto& entry : env->local_frame()) {
+        Definition* def = Cast<Definition>(entry.second);
+        if (def == nullptr) continue;
+        def->makeImmortal();
+        if (Parameters* params = def->parameters()) {
+          params->makeImmortal();
+          for (Parameter* param : params->elements()) {
+            param->makeImmortal();
+            make_immortal(param->default_value());
+          }
+        }
+      }
+      env->is_frozen(true);
+      #ifdef DEBUG_SHARED_PTR
+      SharedObj::setTaint(true);
+      #endif
+      return env;
+    }();
+    return env;
   }
 
 
@@ -854,7 +1066,7 @@ namespace Sass {
   {
     Definition* def = make_c_function(descr, ctx);
     def->environment(env);
-    (*env)[def->name() + "[f]"] = def;
+    env->set_local(def->name() + "[f]", def);
   }
 
 }
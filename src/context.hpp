@@ -4,6 +4,7 @@
 // sass.hpp must go before all system headers to get the
 // __EXTENSIONS__ fix on Solaris.
 #include "sass.hpp"
+#include <unordered_map>
 #include "ast.hpp"
 
 
@@ -14,9 +15,29 @@
 #include "stylesheet.hpp"
 #include "plugins.hpp"
 #include "output.hpp"
+#include "file_index.hpp"
 
 namespace Sass {
 
+  // text parsed again for an evaluated interpolation
+  // the parsed nodes only depend on the text and on
+  // the source position of the interpolation
+  struct ParsedText {
+    const char* path;
+    Position position;
+    sass::string text;
+    ParsedText(const SourceSpan& pstate, sass::string&& text)
+    : path(pstate.path), position(pstate), text(std::move(text))
+    { }
+    bool operator==(const ParsedText& rhs) const {
+      return path == rhs.path && position == rhs.position && text == rhs.text;
+    }
+  };
+
+  struct ParsedTextHash {
+    size_t operator()(const ParsedText& key) const;
+  };
+
   class Context {
   public:
     void import_url (Import* imp, sass::string load_path, const sass::string& ctx_path);
@@ -36,12 +57,19 @@ namespace Sass {
     Plugins plugins;
     Output emitter;
 
-    // generic ast node garbage container
-    // used to avoid possible circular refs
-    CallStack ast_gc;
+    // arena for all ast nodes created by us
+    // activated while the compiler is running
+    // (null unless built with SASS_ARENA_ALLOCATOR)
+    Memory::Arena* arena;
+
     // resources add under our control
     // these are guaranteed to be freed
     sass::vector<char*> strings;
+    // selectors and media queries parsed from interpolations
+    // users must clone them, cleared when the limit is reached
+    std::unordered_map<ParsedText, SelectorListObj, ParsedTextHash> parsed_selectors;
+    std::unordered_map<ParsedText, sass::vector<CssMediaQuery_Obj>, ParsedTextHash> parsed_media_queries;
+    static const size_t parsed_texts_limit = 1024;
     sass::vector<Resource> resources;
     std::map<const sass::string, StyleSheet> sheets;
     ImporterStack import_stack;
@@ -59,6 +87,7 @@ namespace Sass {
 
     sass::vector<sass::string> plugin_paths; // relative paths to load plugins
     sass::vector<sass::string> include_paths; // lookup paths for includes
+    File::DirectoryIndex dir_index; // cached listings to resolve includes
 
     void apply_custom_headers(Block_Obj root, const char* path, SourceSpan pstate);
 
@@ -92,7 +121,18 @@ namespace Sass {
     Sass_Output_Style output_style() { return c_options.output_style; };
     sass::vector<sass::string> get_included_files(bool skip = false, size_t headers = 0);
 
+  protected:
+    // read a stylesheet from disk (mapped if enabled)
+    char* read_resource(const sass::string& path, size_t& mapped) const;
+
   private:
+    // check if we can use the stylesheet cache for the resource
+    bool use_sheet_cache(size_t idx) const;
+    Block_Obj load_cached_sheet(const char* contents, SourceSpan& pstate);
+    // check if we can load precompiled stylesheets
+    bool use_precompiled() const;
+    Block_Obj parse_sheet(const char* contents, SourceSpan& pstate);
+
     void collect_plugin_paths(const char* paths_str);
     void collect_plugin_paths(string_list* paths_array);
     void collect_include_paths(const char* paths_str);
@@ -117,6 +157,9 @@ namespace Sass {
     { }
     virtual ~File_Context();
     virtual Block_Obj parse();
+    void precompile();
+  private:
+    bool load_entry();
   };
 
   class Data_Context : public Context {
@@ -5,10 +5,17 @@
 #include "util_string.hpp"
 #include "util.hpp"
 
+#include <cstring>
+#include <algorithm>
+
 namespace Sass {
 
   Emitter::Emitter(struct Sass_Output_Options& opt)
   : wbuf(),
+    writer(0),
+    writer_cookie(0),
+    streamed(0),
+    streamed_ascii(true),
     opt(opt),
     indentation(0),
     scheduled_space(0),
@@ -31,6 +38,51 @@ namespace Sass {
     return wbuf.buffer;
   }
 
+  // STREAMING TO THE OUTPUT WRITER
+
+  // flush the buffer once it holds a chunk (plus the kept tail)
+  static const size_t OUTPUT_CHUNK = 64 * 1024;
+
+  void Emitter::set_writer(Sass_Output_Writer writer, void* cookie)
+  {
+    this->writer = writer;
+    this->writer_cookie = cookie;
+  }
+
+  void Emitter::write_output(const char* data, size_t length, enum Sass_Output_Part part)
+  {
+    for (size_t pos = 0; pos < length; pos += OUTPUT_CHUNK) {
+      size_t size = std::min(OUTPUT_CHUNK, length - pos);
+      writer(data + pos, size, part, writer_cookie);
+    }
+  }
+
+  void Emitter::stream_buffer(size_t keep)
+  {
+    sass::string& buffer = wbuf.buffer;
+    if (buffer.size() <= keep) return;
+    size_t length = buffer.size() - keep;
+    for (size_t i = 0; streamed_ascii && i < length; ++i) {
+      streamed_ascii = Util::ascii_isascii(buffer[i]);
+    }
+    write_output(buffer.data(), length, SASS_OUTPUT_BODY);
+    buffer.erase(0, length);
+    streamed += length;
+  }
+
+  void Emitter::stream_chunks(void)
+  {
+    if (!writer) return;
+    // keep enough to look for the last linefeed
+    size_t keep = std::max<size_t>(std::strlen(opt.linefeed), 1);
+    if (wbuf.buffer.size() >= OUTPUT_CHUNK + keep) stream_buffer(keep);
+  }
+
+  void Emitter::flush_writer(void)
+  {
+    if (writer) stream_buffer(0);
+  }
+
   Sass_Output_Style Emitter::output_style(void) const
   {
     return opt.output_style;
@@ -93,24 +145,6 @@ namespace Sass {
     }
   }
 
-  // prepend some text or token to the buffer
-  void Emitter::prepend_output(const OutputBuffer& output)
-  {
-    wbuf.smap.prepend(output);
-    wbuf.buffer = output.buffer + wbuf.buffer;
-  }
-
-  // prepend some text or token to the buffer
-  void Emitter::prepend_string(const sass::string& text)
-  {
-    // do not adjust mappings for utf8 bom
-    // seems they are not counted in any UA
-    if (text.compare("\xEF\xBB\xBF") != 0) {
-      wbuf.smap.prepend(Offset(text));
-    }
-    wbuf.buffer = text + wbuf.buffer;
-  }
-
   char Emitter::last_char()
   {
     return wbuf.buffer.back();
@@ -125,6 +159,8 @@ namespace Sass {
     wbuf.buffer += chr;
     // account for data in source-maps
     wbuf.smap.append(Offset(chr));
+    // pass full chunks on
+    stream_chunks();
   }
 
   // append some text or token to the buffer
@@ -147,6 +183,9 @@ namespace Sass {
       // account for data in source-maps
       wbuf.smap.append(Offset(text));
     }
+
+    // pass full chunks on
+    stream_chunks();
   }
 
   // append some white-space only text
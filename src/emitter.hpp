@@ -6,6 +6,7 @@
 #include "sass.hpp"
 
 #include "sass/base.h"
+#include "sass/context.h"
 #include "source_map.hpp"
 #include "ast_fwd_decl.hpp"
 
@@ -20,6 +21,17 @@ namespace Sass {
 
     protected:
       OutputBuffer wbuf;
+      // receives the buffer in chunks while it grows
+      Sass_Output_Writer writer;
+      void* writer_cookie;
+      // bytes passed to the writer (no longer in the buffer)
+      size_t streamed;
+      // none of them was a non-ascii char
+      bool streamed_ascii;
+      // passes the buffer to the writer, but its last `keep` bytes
+      void stream_buffer(size_t keep);
+      // passes it on once it holds a full chunk
+      void stream_chunks(void);
     public:
       const sass::string& buffer(void) { return wbuf.buffer; }
       const SourceMap smap(void) { return wbuf.smap; }
@@ -60,15 +72,19 @@ namespace Sass {
     public:
       // return buffer as sass::string
       sass::string get_buffer(void);
+      // stream the output to the writer while it is emitted, the
+      // buffer keeps only its tail (the last chars are looked at)
+      void set_writer(Sass_Output_Writer writer, void* cookie);
+      // pass the rest of the buffer to the writer
+      void flush_writer(void);
+      // pass text to the writer in chunks of up to 64KB
+      void write_output(const char* data, size_t length, enum Sass_Output_Part part);
       // flush scheduled space/linefeed
       Sass_Output_Style output_style(void) const;
       // add outstanding linefeed
       void finalize(bool final = true);
       // flush scheduled space/linefeed
       void flush_schedules(void);
-      // prepend some text or token to the buffer
-      void prepend_string(const sass::string& text);
-      void prepend_output(const OutputBuffer& out);
       // append some text or token to the buffer
       void append_string(const sass::string& text);
       // append a single character to buffer
@@ -4,20 +4,81 @@
 
 namespace Sass {
 
+  // frames bigger than this get an index for lookups by name
+  static const size_t INDEX_MIN_SLOTS = 16;
+
+  template <typename T>
+  EnvFrame<T>::EnvFrame()
+  : slots_(), mask_(0), index_()
+  { }
+
+  template <typename T>
+  size_t EnvFrame<T>::locate(const Symbol& key) const
+  {
+    if (!may_contain(key)) return npos;
+    if (!index_.empty()) {
+      auto it = index_.find(key);
+      return it == index_.end() ? npos : it->second;
+    }
+    for (size_t i = 0, S = slots_.size(); i < S; ++i) {
+      if (slots_[i].first == key) return i;
+    }
+    return npos;
+  }
+
+  template <typename T>
+  size_t EnvFrame<T>::find(const Symbol& key) const
+  {
+    size_t slot = locate(key);
+    if (slot != npos && !slots_[slot].live) return npos;
+    return slot;
+  }
+
+  template <typename T>
+  size_t EnvFrame<T>::insert(const Symbol& key)
+  {
+    size_t slot = locate(key);
+    if (slot != npos) {
+      slots_[slot].live = true;
+      return slot;
+    }
+    slot = slots_.size();
+    slots_.push_back({ key, T(), true });
+    mask_ |= bit(key.hash());
+    if (!index_.empty()) {
+      index_.emplace(key, slot);
+    }
+    else if (slots_.size() >= INDEX_MIN_SLOTS) {
+      for (size_t i = 0; i < slots_.size(); ++i) {
+        index_.emplace(slots_[i].first, i);
+      }
+    }
+    return slot;
+  }
+
+  template <typename T>
+  void EnvFrame<T>::erase(const Symbol& key)
+  {
+    size_t slot = find(key);
+    if (slot == npos) return;
+    slots_[slot].second = T();
+    slots_[slot].live = false;
+  }
+
   template <typename T>
   Environment<T>::Environment(bool is_shadow)
-  : local_frame_(environment_map<sass::string, T>()),
-    parent_(0), is_shadow_(false)
+  : local_frame_(),
+    parent_(0), is_shadow_(false), is_frozen_(false)
   { }
   template <typename T>
   Environment<T>::Environment(Environment<T>* env, bool is_shadow)
-  : local_frame_(environment_map<sass::string, T>()),
-    parent_(env), is_shadow_(is_shadow)
+  : local_frame_(),
+    parent_(env), is_shadow_(is_shadow), is_frozen_(false)
   { }
   template <typename T>
   Environment<T>::Environment(Environment<T>& env, bool is_shadow)
-  : local_frame_(environment_map<sass::string, T>()),
-    parent_(&env), is_shadow_(is_shadow)
+  : local_frame_(),
+    parent_(&env), is_shadow_(is_shadow), is_frozen_(false)
   { }
 
   // link parent to create a stack
@@ -26,12 +87,20 @@ namespace Sass {
   template <typename T>
   void Environment<T>::link(Environment* env) { parent_ = env; }
 
+  // the root frame is the last on the stack
+  // a frozen parent frame (builtins) is skipped
+  template <typename T>
+  bool Environment<T>::is_root() const
+  {
+    return ! parent_ || parent_->is_frozen_;
+  }
+
   // this is used to find the global frame
   // which is the second last on the stack
   template <typename T>
   bool Environment<T>::is_lexical() const
   {
-    return !! parent_ && parent_->parent_;
+    return !! parent_ && ! parent_->is_root();
   }
 
   // only match the real root scope
@@ -41,43 +110,41 @@ namespace Sass {
   template <typename T>
   bool Environment<T>::is_global() const
   {
-    return parent_ && ! parent_->parent_;
+    return parent_ && parent_->is_root();
   }
 
   template <typename T>
-  environment_map<sass::string, T>& Environment<T>::local_frame() {
+  EnvFrame<T>& Environment<T>::local_frame() {
     return local_frame_;
   }
 
   template <typename T>
-  bool Environment<T>::has_local(const sass::string& key) const
-  { return local_frame_.find(key) != local_frame_.end(); }
+  bool Environment<T>::has_local(const Symbol& key) const
+  { return local_frame_.find(key) != EnvFrame<T>::npos; }
 
   template <typename T> EnvResult
-  Environment<T>::find_local(const sass::string& key)
+  Environment<T>::find_local(const Symbol& key)
   {
-    auto end = local_frame_.end();
-    auto it = local_frame_.find(key);
-    return EnvResult(it, it != end);
+    return EnvResult(&local_frame_, local_frame_.find(key));
   }
 
   template <typename T>
-  T& Environment<T>::get_local(const sass::string& key)
+  T& Environment<T>::get_local(const Symbol& key)
   { return local_frame_[key]; }
 
   template <typename T>
-  void Environment<T>::set_local(const sass::string& key, const T& val)
+  void Environment<T>::set_local(const Symbol& key, const T& val)
   {
     local_frame_[key] = val;
   }
   template <typename T>
-  void Environment<T>::set_local(const sass::string& key, T&& val)
+  void Environment<T>::set_local(const Symbol& key, T&& val)
   {
     local_frame_[key] = val;
   }
 
   template <typename T>
-  void Environment<T>::del_local(const sass::string& key)
+  void Environment<T>::del_local(const Symbol& key)
   { local_frame_.erase(key); }
 
   template <typename T>
@@ -91,30 +158,30 @@ namespace Sass {
   }
 
   template <typename T>
-  bool Environment<T>::has_global(const sass::string& key)
+  bool Environment<T>::has_global(const Symbol& key)
   { return global_env()->has(key); }
 
   template <typename T>
-  T& Environment<T>::get_global(const sass::string& key)
+  T& Environment<T>::get_global(const Symbol& key)
   { return (*global_env())[key]; }
 
   template <typename T>
-  void Environment<T>::set_global(const sass::string& key, const T& val)
+  void Environment<T>::set_global(const Symbol& key, const T& val)
   {
     global_env()->local_frame_[key] = val;
   }
   template <typename T>
-  void Environment<T>::set_global(const sass::string& key, T&& val)
+  void Environment<T>::set_global(const Symbol& key, T&& val)
   {
     global_env()->local_frame_[key] = val;
   }
 
   template <typename T>
-  void Environment<T>::del_global(const sass::string& key)
+  void Environment<T>::del_global(const Symbol& key)
   { global_env()->local_frame_.erase(key); }
 
   template <typename T>
-  Environment<T>* Environment<T>::lexical_env(const sass::string& key)
+  Environment<T>* Environment<T>::lexical_env(const Symbol& key)
   {
     Environment* cur = this;
     while (cur) {
@@ -130,7 +197,7 @@ namespace Sass {
   // move down the stack but stop before we
   // reach the global frame (is not included)
   template <typename T>
-  bool Environment<T>::has_lexical(const sass::string& key) const
+  bool Environment<T>::has_lexical(const Symbol& key) const
   {
     auto cur = this;
     while (cur->is_lexical()) {
@@ -144,14 +211,14 @@ namespace Sass {
   // either update already existing lexical value
   // or if flag is set, we create one if no lexical found
   template <typename T>
-  void Environment<T>::set_lexical(const sass::string& key, const T& val)
+  void Environment<T>::set_lexical(const Symbol& key, const T& val)
   {
     Environment<T>* cur = this;
     bool shadow = false;
     while ((cur && cur->is_lexical()) || shadow) {
       EnvResult rv(cur->find_local(key));
       if (rv.found) {
-        rv.it->second = val;
+        rv.value() = val;
         return;
       }
       shadow = cur->is_shadow();
@@ -161,14 +228,14 @@ namespace Sass {
   }
   // this one moves the value
   template <typename T>
-  void Environment<T>::set_lexical(const sass::string& key, T&& val)
+  void Environment<T>::set_lexical(const Symbol& key, T&& val)
   {
     Environment<T>* cur = this;
     bool shadow = false;
     while ((cur && cur->is_lexical()) || shadow) {
       EnvResult rv(cur->find_local(key));
       if (rv.found) {
-        rv.it->second = val;
+        rv.value() = val;
         return;
       }
       shadow = cur->is_shadow();
@@ -180,7 +247,7 @@ namespace Sass {
   // look on the full stack for key
   // include all scopes available
   template <typename T>
-  bool Environment<T>::has(const sass::string& key) const
+  bool Environment<T>::has(const Symbol& key) const
   {
     auto cur = this;
     while (cur) {
@@ -195,42 +262,54 @@ namespace Sass {
   // look on the full stack for key
   // include all scopes available
   template <typename T> EnvResult
-  Environment<T>::find(const sass::string& key)
+  Environment<T>::find(const Symbol& key)
+  {
+    size_t slot = EnvFrame<T>::npos;
+    return find(key, slot);
+  }
+
+  // frames that can't hold the name are skipped
+  // by their filter without looking at any slot
+  template <typename T> EnvResult
+  Environment<T>::find(const Symbol& key, size_t& slot)
   {
     auto cur = this;
     while (true) {
-      EnvResult rv(cur->find_local(key));
-      if (rv.found) return rv;
+      EnvFrame<T>& frame = cur->local_frame_;
+      if (frame.may_contain(key)) {
+        if (frame.holds(slot, key)) {
+          return EnvResult(&frame, slot);
+        }
+        size_t found = frame.find(key);
+        if (found != EnvFrame<T>::npos) {
+          slot = found;
+          return EnvResult(&frame, slot);
+        }
+      }
+      if (!cur->parent_) {
+        return EnvResult(&frame, EnvFrame<T>::npos);
+      }
       cur = cur->parent_;
-      if (!cur) return rv;
     }
-  };
+  }
 
   // use array access for getter and setter functions
   template <typename T>
-  T& Environment<T>::get(const sass::string& key)
+  T& Environment<T>::get(const Symbol& key)
   {
-    auto cur = this;
-    while (cur) {
-      if (cur->has_local(key)) {
-        return cur->get_local(key);
-      }
-      cur = cur->parent_;
-    }
+    // avoid `operator[]` on the frames, as
+    // they might be shared between threads
+    EnvResult rv(find(key));
+    if (rv.found) return rv.value();
     return get_local(key);
   }
 
   // use array access for getter and setter functions
   template <typename T>
-  T& Environment<T>::operator[](const sass::string& key)
+  T& Environment<T>::operator[](const Symbol& key)
   {
-    auto cur = this;
-    while (cur) {
-      if (cur->has_local(key)) {
-        return cur->get_local(key);
-      }
-      cur = cur->parent_;
-    }
+    EnvResult rv(find(key));
+    if (rv.found) return rv.value();
     return get_local(key);
   }
 /*
@@ -241,7 +320,7 @@ namespace Sass {
     size_t indent = 0;
     if (parent_) indent = parent_->print(prefix) + 1;
     std::cerr << prefix << sass::string(indent, ' ') << "== " << this << std::endl;
-    for (typename environment_map<sass::string, T>::iterator i = local_frame_.begin(); i != local_frame_.end(); ++i) {
+    for (auto i = local_frame_.begin(); i != local_frame_.end(); ++i) {
       if (!ends_with(i->first, "[f]") && !ends_with(i->first, "[f]4") && !ends_with(i->first, "[f]2")) {
         std::cerr << prefix << sass::string(indent, ' ') << i->first << " " << i->second;
         if (Value* val = Cast<Value>(i->second))
@@ -254,6 +333,7 @@ namespace Sass {
   #endif
 */
   // compile implementation for AST_Node
+  template class EnvFrame<AST_Node_Obj>;
   template class Environment<AST_Node_Obj>;
 
 }
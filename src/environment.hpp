@@ -5,31 +5,93 @@
 // __EXTENSIONS__ fix on Solaris.
 #include "sass.hpp"
 
-#include <map>
 #include <string>
+#include <cstdint>
+#include <unordered_map>
 #include "ast_fwd_decl.hpp"
 #include "ast_def_macros.hpp"
+#include "symbol.hpp"
 
 namespace Sass {
 
-  // this defeats the whole purpose of environment being templatable!!
-  typedef environment_map<sass::string, AST_Node_Obj>::iterator EnvIter;
+  // One scope of variables, functions and mixins. Entries are kept
+  // in slots (in order of definition) and keep their slot for the
+  // lifetime of the frame; erased entries leave an empty slot behind.
+  // Frames executing the same code get the same layout, so callers
+  // can remember the slot of a name and check it first next time.
+  template <typename T>
+  class EnvFrame {
+
+  public:
+    struct Slot {
+      Symbol first;
+      T second;
+      bool live;
+    };
+
+    static const size_t npos = sass::string::npos;
+
+  private:
+    sass::vector<Slot> slots_;
+    // bloom filter over the hashes of all names
+    uint64_t mask_;
+    // name lookup for frames too big for a linear scan
+    std::unordered_map<Symbol, size_t> index_;
+
+    static uint64_t bit(size_t hash) { return uint64_t(1) << (hash & 63); }
+    // find slot of name even if it was erased
+    size_t locate(const Symbol& key) const;
+
+  public:
+    EnvFrame();
+
+    // false if the name is certainly not in this frame
+    bool may_contain(const Symbol& key) const { return (mask_ & bit(key.hash())) != 0; }
+
+    // slot of the name, or npos if not found
+    size_t find(const Symbol& key) const;
+
+    // check if the slot (maybe from an earlier lookup) holds the name
+    bool holds(size_t slot, const Symbol& key) const
+    {
+      if (slot >= slots_.size()) return false;
+      const Slot& entry = slots_[slot];
+      return entry.live && entry.first == key;
+    }
+
+    T& at(size_t slot) { return slots_[slot].second; }
+
+    // get the slot for the name, create it if needed
+    size_t insert(const Symbol& key);
+    T& operator[](const Symbol& key) { return at(insert(key)); }
+
+    void erase(const Symbol& key);
+
+    typename sass::vector<Slot>::iterator begin() { return slots_.begin(); }
+    typename sass::vector<Slot>::iterator end() { return slots_.end(); }
+
+  };
 
   class EnvResult {
     public:
-      EnvIter it;
+      EnvFrame<AST_Node_Obj>* frame;
+      size_t slot;
       bool found;
     public:
-      EnvResult(EnvIter it, bool found)
-      : it(it), found(found) {}
+      EnvResult(EnvFrame<AST_Node_Obj>* frame, size_t slot)
+      : frame(frame), slot(slot), found(slot != EnvFrame<AST_Node_Obj>::npos) {}
+      // only valid if found
+      AST_Node_Obj& value() { return frame->at(slot); }
   };
 
   template <typename T>
   class Environment {
-    // TODO: test with map
-    environment_map<sass::string, T> local_frame_;
+    EnvFrame<T> local_frame_;
     ADD_PROPERTY(Environment*, parent)
     ADD_PROPERTY(bool, is_shadow)
+    // frozen frames are shared between contexts
+    // and must therefore never be modified
+    ADD_PROPERTY(bool, is_frozen)
 
   public:
     Environment(bool is_shadow = false);
@@ -40,6 +102,10 @@ namespace Sass {
     void link(Environment& env);
     void link(Environment* env);
 
+    // the root frame is the last on the stack
+    // a frozen parent frame (builtins) is skipped
+    bool is_root() const;
+
     // this is used to find the global frame
     // which is the second last on the stack
     bool is_lexical() const;
@@ -52,62 +118,66 @@ namespace Sass {
 
     // scope operates on the current frame
 
-    environment_map<sass::string, T>& local_frame();
+    EnvFrame<T>& local_frame();
 
-    bool has_local(const sass::string& key) const;
+    bool has_local(const Symbol& key) const;
 
-    EnvResult find_local(const sass::string& key);
+    EnvResult find_local(const Symbol& key);
 
-    T& get_local(const sass::string& key);
+    T& get_local(const Symbol& key);
 
     // set variable on the current frame
-    void set_local(const sass::string& key, const T& val);
-    void set_local(const sass::string& key, T&& val);
+    void set_local(const Symbol& key, const T& val);
+    void set_local(const Symbol& key, T&& val);
 
-    void del_local(const sass::string& key);
+    void del_local(const Symbol& key);
 
     // global operates on the global frame
     // which is the second last on the stack
     Environment* global_env();
     // get the env where the variable already exists
     // if it does not yet exist, we return current env
-    Environment* lexical_env(const sass::string& key);
+    Environment* lexical_env(const Symbol& key);
 
-    bool has_global(const sass::string& key);
+    bool has_global(const Symbol& key);
 
-    T& get_global(const sass::string& key);
+    T& get_global(const Symbol& key);
 
     // set a variable on the global frame
-    void set_global(const sass::string& key, const T& val);
-    void set_global(const sass::string& key, T&& val);
+    void set_global(const Symbol& key, const T& val);
+    void set_global(const Symbol& key, T&& val);
 
-    void del_global(const sass::string& key);
+    void del_global(const Symbol& key);
 
     // see if we have a lexical variable
     // move down the stack but stop before we
     // reach the global frame (is not included)
-    bool has_lexical(const sass::string& key) const;
+    bool has_lexical(const Symbol& key) const;
 
     // see if we have a lexical we could update
     // either update already existing lexical value
     // or we create a new one on the current frame
-    void set_lexical(const sass::string& key, T&& val);
-    void set_lexical(const sass::string& key, const T& val);
+    void set_lexical(const Symbol& key, T&& val);
+    void set_lexical(const Symbol& key, const T& val);
 
     // look on the full stack for key
     // include all scopes available
-    bool has(const sass::string& key) const;
+    bool has(const Symbol& key) const;
 
     // look on the full stack for key
     // include all scopes available
-    T& get(const sass::string& key);
+    T& get(const Symbol& key);
 
     // look on the full stack for key
     // include all scopes available
-    EnvResult find(const sass::string& key);
+    EnvResult find(const Symbol& key);
+
+    // same as above, but checks the slot where the name was
+    // found before first and updates it for the next lookup
+    EnvResult find(const Symbol& key, size_t& slot);
 
     // use array access for getter and setter functions
-    T& operator[](const sass::string& key);
+    T& operator[](const Symbol& key);
 
     #ifdef DEBUG
     size_t print(sass::string prefix = "");
@@ -90,7 +90,7 @@ namespace Sass {
   Expression* Eval::operator()(Assignment* a)
   {
     Env* env = environment();
-    sass::string var(a->variable());
+    const Symbol& var(a->symbol());
     if (a->is_global()) {
       if (a->is_default()) {
         if (env->has_global(var)) {
@@ -169,7 +169,7 @@ namespace Sass {
   // But iteration vars are reset afterwards
   Expression* Eval::operator()(ForRule* f)
   {
-    sass::string variable(f->variable());
+    Symbol variable(f->variable());
     ExpressionObj low = f->lower_bound()->perform(this);
     if (low->concrete_type() != Expression::NUMBER) {
       traces.push_back(Backtrace(low->pstate()));
@@ -201,7 +201,10 @@ namespace Sass {
       for (double i = start;
            i < end;
            ++i) {
-        Number_Obj it = SASS_MEMORY_NEW(Number, low->pstate(), i, sass_end->unit());
+        Number_Obj it = SASS_MEMORY_NEW(Number, low->pstate(), i);
+        // copy the units, parsing their names again would intern custom ones
+        it->numerators = sass_end->numerators;
+        it->denominators = sass_end->denominators;
         env.set_local(variable, it);
         val = body->perform(this);
         if (val) break;
@@ -211,7 +214,10 @@ namespace Sass {
       for (double i = start;
            i > end;
            --i) {
-        Number_Obj it = SASS_MEMORY_NEW(Number, low->pstate(), i, sass_end->unit());
+        Number_Obj it = SASS_MEMORY_NEW(Number, low->pstate(), i);
+        // copy the units, parsing their names again would intern custom ones
+        it->numerators = sass_end->numerators;
+        it->denominators = sass_end->denominators;
         env.set_local(variable, it);
         val = body->perform(this);
         if (val) break;
@@ -225,7 +231,10 @@ namespace Sass {
   // But iteration vars are reset afterwards
   Expression* Eval::operator()(EachRule* e)
   {
-    sass::vector<sass::string> variables(e->variables());
+    sass::vector<Symbol> variables;
+    for (const sass::string& variable : e->variables()) {
+      variables.push_back(variable);
+    }
     ExpressionObj expr = e->list()->perform(this);
     Env env(environment(), true);
     env_stack().push_back(&env);
@@ -965,15 +974,19 @@ namespace Sass {
       return SASS_MEMORY_NEW(String_Constant, c->pstate(), str);
     }
 
-    sass::string name(Util::normalize_underscores(c->name()));
-    sass::string full_name(name + "[f]");
+    static const Symbol generic_fn("*[f]");
+    static const Symbol call_fn("call[f]");
+    static const Symbol if_fn("if[f]");
+
+    Symbol full_name(c->lookup());
 
     // we make a clone here, need to implement that further
     Arguments_Obj args = c->arguments();
 
     Env* env = environment();
-    if (!env->has(full_name) || (!c->via_call() && Prelexer::re_special_fun(name.c_str()))) {
-      if (!env->has("*[f]")) {
+    if (!env->has(full_name) || (!c->via_call() &&
+        Prelexer::re_special_fun(Util::normalize_underscores(c->name()).c_str()))) {
+      if (!env->has(generic_fn)) {
         for (Argument_Obj arg : args->elements()) {
           if (List_Obj ls = Cast<List>(arg->value())) {
             if (ls->size() == 0) error("() isn't a valid CSS value.", c->pstate(), traces);
@@ -982,8 +995,10 @@ namespace Sass {
         args = Cast<Arguments>(args->perform(this));
         Function_Call_Obj lit = SASS_MEMORY_NEW(Function_Call,
                                              c->pstate(),
-                                             c->name(),
+                                             String_Obj{},
                                              args);
+        // only printed, the name (maybe passed to `call`) isn't interned
+        lit->sname(SASS_MEMORY_NEW(String_Constant, c->pstate(), c->name()), false);
         if (args->has_named_arguments()) {
           error("Plain CSS function " + c->name() + " doesn't support keyword arguments", c->pstate(), traces);
         }
@@ -994,15 +1009,15 @@ namespace Sass {
         return str;
       } else {
         // call generic function
-        full_name = "*[f]";
+        full_name = generic_fn;
       }
     }
 
     // further delay for calls
-    if (full_name != "call[f]") {
+    if (full_name != call_fn) {
       args->set_delayed(false); // verified
     }
-    if (full_name != "if[f]") {
+    if (full_name != if_fn) {
       args = Cast<Arguments>(args->perform(this));
     }
     Definition* def = Cast<Definition>((*env)[full_name]);
@@ -1010,7 +1025,6 @@ namespace Sass {
     if (c->func()) def = c->func()->definition();
 
     if (def->is_overload_stub()) {
-      sass::sstream ss;
       size_t L = args->length();
       // account for rest arguments
       if (args->has_rest_argument() && args->length() > 0) {
@@ -1019,9 +1033,9 @@ namespace Sass {
         // arguments before rest argument plus rest
         if (rest) L += rest->length() - 1;
       }
-      ss << full_name << L;
-      full_name = ss.str();
-      sass::string resolved_name(full_name);
+      // looked up without interning, wrong arities give the empty symbol
+      Symbol resolved_name(full_name == c->lookup() ? c->overload(L)
+        : Symbol::find(full_name.str() + std::to_string(L)));
       if (!env->has(resolved_name)) error("overloaded function `" + sass::string(c->name()) + "` given wrong number of arguments", c->pstate(), traces);
       def = Cast<Definition>((*env)[resolved_name]);
     }
@@ -1068,7 +1082,7 @@ namespace Sass {
     // convert call into C-API compatible form
     else if (c_function) {
       Sass_Function_Fn c_func = sass_function_get_function(c_function);
-      if (full_name == "*[f]") {
+      if (full_name == generic_fn) {
         String_Quoted_Obj str = SASS_MEMORY_NEW(String_Quoted, c->pstate(), c->name());
         Arguments_Obj new_args = SASS_MEMORY_NEW(Arguments, c->pstate());
         new_args->append(SASS_MEMORY_NEW(Argument, c->pstate(), str));
@@ -1122,7 +1136,7 @@ namespace Sass {
 
     // link back to function definition
     // only do this for custom functions
-    if (result->pstate().file == sass::string::npos)
+    if (result->pstate().file == Position::npos)
       result->pstate(c->pstate());
 
     result = result->perform(this);
@@ -1135,9 +1149,10 @@ namespace Sass {
   {
     ExpressionObj value;
     Env* env = environment();
-    const sass::string& name(v->name());
-    EnvResult rv(env->find(name));
-    if (rv.found) value = static_cast<Expression*>(rv.it->second.ptr());
+    size_t slot = v->slot();
+    EnvResult rv(env->find(v->symbol(), slot));
+    v->slot(slot);
+    if (rv.found) value = static_cast<Expression*>(rv.value().ptr());
     else error("Undefined variable: \"" + v->name() + "\".", v->pstate(), traces);
     if (Argument* arg = Cast<Argument>(value)) value = arg->value();
     if (Number* nr = Cast<Number>(value)) nr->zero(true); // force flag
@@ -1145,7 +1160,7 @@ namespace Sass {
     if (force) value->is_expanded(false);
     value->set_delayed(false); // verified
     value = value->perform(this);
-    if(!force) rv.it->second = value;
+    if(!force) rv.value() = value;
     return value.detach();
   }
 
@@ -1496,6 +1511,52 @@ namespace Sass {
     return 0;
   }
 
+  // point the span of a parsed node to the source of the
+  // interpolation (its position is already relative to it)
+  static void rebase_span(AST_Node* node, const char* src)
+  {
+    SourceSpan pstate(node->pstate());
+    pstate.src = src;
+    node->pstate(pstate);
+  }
+
+  // attribute values and pseudo arguments may be schemas
+  static void rebase_pstate(String* string, const char* src)
+  {
+    rebase_span(string, src);
+    if (String_Schema* schema = Cast<String_Schema>(string)) {
+      for (PreValue* part : schema->elements()) {
+        if (String* nested = Cast<String>(part)) rebase_pstate(nested, src);
+        else rebase_span(part, src);
+      }
+    }
+  }
+
+  // point all spans of a parsed selector to the source of the
+  // interpolation, including the strings held by simple selectors
+  static void rebase_pstate(SelectorList* list, const char* src)
+  {
+    rebase_span(list, src);
+    for (ComplexSelector* complex : list->elements()) {
+      rebase_span(complex, src);
+      for (SelectorComponent* component : complex->elements()) {
+        rebase_span(component, src);
+        CompoundSelector* compound = component->getCompound();
+        if (compound == nullptr) continue;
+        for (SimpleSelector* simple : compound->elements()) {
+          rebase_span(simple, src);
+          if (AttributeSelector* attribute = Cast<AttributeSelector>(simple)) {
+            if (attribute->value()) rebase_pstate(attribute->value(), src);
+          }
+          else if (PseudoSelector* pseudo = Cast<PseudoSelector>(simple)) {
+            if (pseudo->argument()) rebase_pstate(pseudo->argument(), src);
+            if (pseudo->selector()) rebase_pstate(pseudo->selector(), src);
+          }
+        }
+      }
+    }
+  }
+
   SelectorList* Eval::operator()(Selector_Schema* s)
   {
     LOCAL_FLAG(is_in_selector_schema, true);
@@ -1503,15 +1564,30 @@ namespace Sass {
     ExpressionObj sel = s->contents()->perform(this);
     sass::string result_str(sel->to_string(options()));
     result_str = unquote(Util::rtrim(result_str));
-    char* temp_cstr = sass_copy_c_string(result_str.c_str());
-    ctx.strings.push_back(temp_cstr); // attach to context
-    Parser p = Parser::from_c_str(temp_cstr, ctx, traces, s->pstate());
-
-    // If a schema contains a reference to parent it is already
-    // connected to it, so don't connect implicitly anymore
-    SelectorListObj parsed = p.parseSelectorList(true);
+    // parse every resulting text only once (e.g. inside mixins)
+    ParsedText key(s->pstate(), std::move(result_str));
+    auto parsed = ctx.parsed_selectors.find(key);
+    if (parsed == ctx.parsed_selectors.end()) {
+      if (ctx.parsed_selectors.size() >= Context::parsed_texts_limit) {
+        ctx.parsed_selectors.clear();
+      }
+      parsed = ctx.parsed_selectors.emplace(std::move(key), SelectorListObj()).first;
+      Parser p = Parser::from_c_str(parsed->first.text.c_str(), ctx, traces, s->pstate());
+      try {
+        // If a schema contains a reference to parent it is already
+        // connected to it, so don't connect implicitly anymore
+        parsed->second = p.parseSelectorList(true);
+      }
+      catch (...) {
+        ctx.parsed_selectors.erase(parsed);
+        throw;
+      }
+      // the text is dropped with the entry
+      rebase_pstate(parsed->second, s->pstate().src);
+    }
     flag_is_in_selector_schema.reset();
-    return parsed.detach();
+    // the memoized list must not be altered
+    return SASS_MEMORY_CLONE(parsed->second);
   }
 
   Expression* Eval::operator()(Parent_Reference* p)
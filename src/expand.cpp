@@ -257,13 +257,39 @@ namespace Sass {
   Statement* Expand::operator()(MediaRule* m)
   {
     ExpressionObj mq = eval(m->schema());
-    sass::string str_mq(mq->to_css(ctx.c_options));
-    char* str = sass_copy_c_string(str_mq.c_str());
-    ctx.strings.push_back(str);
-    Parser parser(Parser::from_c_str(str, ctx, traces, mq->pstate()));
+    // parse every resulting text only once (e.g. inside mixins)
+    ParsedText key(mq->pstate(), mq->to_css(ctx.c_options));
+    auto memo = ctx.parsed_media_queries.find(key);
+    if (memo == ctx.parsed_media_queries.end()) {
+      if (ctx.parsed_media_queries.size() >= Context::parsed_texts_limit) {
+        ctx.parsed_media_queries.clear();
+      }
+      memo = ctx.parsed_media_queries.emplace(std::move(key), sass::vector<CssMediaQuery_Obj>()).first;
+      Parser parser(Parser::from_c_str(memo->first.text.c_str(), ctx, traces, mq->pstate()));
+      try {
+        memo->second = parser.parseCssMediaQueries();
+      }
+      catch (...) {
+        ctx.parsed_media_queries.erase(memo);
+        throw;
+      }
+      // the text is dropped with the entry, point the
+      // queries to the source of the interpolation (they
+      // hold no other nodes, their parts are plain strings)
+      for (CssMediaQuery* query : memo->second) {
+        SourceSpan pstate(query->pstate());
+        pstate.src = mq->pstate().src;
+        query->pstate(pstate);
+      }
+    }
+    // the memoized queries must not be altered
+    sass::vector<CssMediaQuery_Obj> parsed;
+    parsed.reserve(memo->second.size());
+    for (const CssMediaQuery_Obj& query : memo->second) {
+      parsed.push_back(SASS_MEMORY_COPY(query));
+    }
     // Create a new CSS only representation of the media rule
     CssMediaRuleObj css = SASS_MEMORY_NEW(CssMediaRule, m->pstate(), m->block());
-    sass::vector<CssMediaQuery_Obj> parsed = parser.parseCssMediaQueries();
     if (mediaStack.size() && mediaStack.back()) {
       auto& parent = mediaStack.back()->elements();
       css->concat(mergeMediaQueries(parent, parsed));
@@ -356,7 +382,7 @@ namespace Sass {
   Statement* Expand::operator()(Assignment* a)
   {
     Env* env = environment();
-    const sass::string& var(a->variable());
+    const Symbol& var(a->symbol());
     if (a->is_global()) {
       if (a->is_default()) {
         if (env->has_global(var)) {
@@ -516,7 +542,7 @@ namespace Sass {
   // But iteration vars are reset afterwards
   Statement* Expand::operator()(ForRule* f)
   {
-    sass::string variable(f->variable());
+    Symbol variable(f->variable());
     ExpressionObj low = f->lower_bound()->perform(&eval);
     if (low->concrete_type() != Expression::NUMBER) {
       traces.push_back(Backtrace(low->pstate()));
@@ -548,7 +574,10 @@ namespace Sass {
       for (double i = start;
            i < end;
            ++i) {
-        Number_Obj it = SASS_MEMORY_NEW(Number, low->pstate(), i, sass_end->unit());
+        Number_Obj it = SASS_MEMORY_NEW(Number, low->pstate(), i);
+        // copy the units, parsing their names again would intern custom ones
+        it->numerators = sass_end->numerators;
+        it->denominators = sass_end->denominators;
         env.set_local(variable, it);
         append_block(body);
       }
@@ -557,7 +586,10 @@ namespace Sass {
       for (double i = start;
            i > end;
            --i) {
-        Number_Obj it = SASS_MEMORY_NEW(Number, low->pstate(), i, sass_end->unit());
+        Number_Obj it = SASS_MEMORY_NEW(Number, low->pstate(), i);
+        // copy the units, parsing their names again would intern custom ones
+        it->numerators = sass_end->numerators;
+        it->denominators = sass_end->denominators;
         env.set_local(variable, it);
         append_block(body);
       }
@@ -571,7 +603,10 @@ namespace Sass {
   // But iteration vars are reset afterwards
   Statement* Expand::operator()(EachRule* e)
   {
-    sass::vector<sass::string> variables(e->variables());
+    sass::vector<Symbol> variables;
+    for (const sass::string& variable : e->variables()) {
+      variables.push_back(variable);
+    }
     ExpressionObj expr = e->list()->perform(&eval);
     List_Obj list;
     Map_Obj map;
@@ -769,11 +804,10 @@ namespace Sass {
     recursions ++;
 
     Env* env = environment();
-    sass::string full_name(c->name() + "[m]");
-    if (!env->has(full_name)) {
+    if (!env->has(c->lookup())) {
       error("no mixin named " + c->name(), c->pstate(), traces);
     }
-    Definition_Obj def = Cast<Definition>((*env)[full_name]);
+    Definition_Obj def = Cast<Definition>((*env)[c->lookup()]);
     Block_Obj body = def->block();
     Parameters_Obj params = def->parameters();
 
@@ -806,7 +840,8 @@ namespace Sass {
                                           c->block(),
                                           Definition::MIXIN);
       thunk->environment(env);
-      new_env.local_frame()["@content[m]"] = thunk;
+      static const Symbol content("@content[m]");
+      new_env.local_frame()[content] = thunk;
     }
 
     bind(sass::string("Mixin"), c->name(), params, args, &new_env, &eval, traces);
@@ -841,7 +876,8 @@ namespace Sass {
   {
     Env* env = environment();
     // convert @content directives into mixin calls to the underlying thunk
-    if (!env->has("@content[m]")) return 0;
+    static const Symbol content("@content[m]");
+    if (!env->has(content)) return 0;
     Arguments_Obj args = c->arguments();
     if (!args) args = SASS_MEMORY_NEW(Arguments, c->pstate());
 
@@ -3,6 +3,8 @@
 #include "sass.hpp"
 #include "ast.hpp"
 
+#include <algorithm>
+
 #include "extender.hpp"
 #include "permutate.hpp"
 #include "dart_helpers.hpp"
@@ -21,7 +23,9 @@ namespace Sass {
     extensionsByExtender(),
     mediaContexts(),
     sourceSpecificity(),
-    originals()
+    originals(),
+    wrappedSimples(),
+    memoize(true)
   {}
 
   // ##########################################################################
@@ -36,7 +40,9 @@ namespace Sass {
     extensionsByExtender(),
     mediaContexts(),
     sourceSpecificity(),
-    originals()
+    originals(),
+    wrappedSimples(),
+    memoize(true)
   {}
 
   // ##########################################################################
@@ -101,6 +107,7 @@ namespace Sass {
         }
 
         Extender extender(mode, traces);
+        extender.memoize = false;
 
         if (!selector->is_invisible()) {
           for (auto sel : selector->elements()) {
@@ -209,22 +216,34 @@ namespace Sass {
   {
     if (list.isNull() || list->empty()) return;
     for (auto complex : list->elements()) {
-      for (auto component : complex->elements()) {
-        if (auto compound = component->getCompound()) {
-          for (SimpleSelector* simple : compound->elements()) {
-            selectors[simple].insert(rule);
-            if (auto pseudo = simple->getPseudoSelector()) {
-              if (pseudo->selector()) {
-                auto sel = pseudo->selector();
-                registerSelector(sel, rule);
-              }
+      registerComplex(complex, rule);
+    }
+  }
+  // EO registerSelector
+
+  // ##########################################################################
+  // Registers the [SimpleSelector]s in [complex]
+  // to point to [rule] in [selectors].
+  // ##########################################################################
+  void Extender::registerComplex(
+    const ComplexSelectorObj& complex,
+    const SelectorListObj& rule)
+  {
+    for (auto component : complex->elements()) {
+      if (auto compound = component->getCompound()) {
+        for (SimpleSelector* simple : compound->elements()) {
+          selectors[simple].insert(rule);
+          if (auto pseudo = simple->getPseudoSelector()) {
+            if (pseudo->selector()) {
+              auto sel = pseudo->selector();
+              registerSelector(sel, rule);
             }
           }
         }
       }
     }
   }
-  // EO registerSelector
+  // EO registerComplex
 
   // ##########################################################################
   // Returns an extension that combines [left] and [right]. Throws 
@@ -382,8 +401,12 @@ namespace Sass {
     const ExtListSelSet& rules,
     const ExtSelExtMap& newExtensions)
   {
+    // [rules] keeps the order the rules were added in. Registering the
+    // extended selectors only inserts rules that are in it already, but
+    // go by index and hold the rule in case the vector grows anyway.
     // Is a modifyableCssStyleRUle in dart sass
-    for (const SelectorListObj& rule : rules) {
+    for (size_t i = 0, L = rules.size(); i < L; i += 1) {
+      SelectorListObj rule = rules.keys()[i];
       const SelectorListObj& oldValue = SASS_MEMORY_COPY(rule);
       CssMediaRuleObj mediaContext;
       if (mediaContexts.hasKey(rule)) mediaContext = mediaContexts.get(rule);
@@ -392,7 +415,19 @@ namespace Sass {
       // failed), we don't need to re-register the selector.
       if (ObjEqualityFn(oldValue, ext)) continue;
       rule->elements(ext->elements());
-      registerSelector(rule, rule);
+      // Complex selectors kept from [oldValue] are registered already,
+      // only the ones added by extending need to point to [rule].
+      sass::vector<const ComplexSelector*> registered;
+      registered.reserve(oldValue->length());
+      for (const ComplexSelectorObj& complex : oldValue->elements()) {
+        registered.push_back(complex.ptr());
+      }
+      std::sort(registered.begin(), registered.end());
+      for (const ComplexSelectorObj& complex : rule->elements()) {
+        if (!std::binary_search(registered.begin(), registered.end(), complex.ptr())) {
+          registerComplex(complex, rule);
+        }
+      }
 
     }
   }
@@ -659,7 +694,9 @@ namespace Sass {
   Extension Extender::extensionForSimple(
     const SimpleSelectorObj& simple) const
   {
-    Extension extension(simple->wrapInComplex());
+    ComplexSelectorObj& wrapped = wrappedSimples[simple];
+    if (wrapped.isNull()) wrapped = simple->wrapInComplex();
+    Extension extension(wrapped);
     extension.specificity = maxSourceSpecificity(simple);
     extension.isOriginal = true;
     return extension;
@@ -827,7 +864,8 @@ namespace Sass {
           merged->concat(originals);
           toUnify.insert(toUnify.begin(), { merged });
         }
-        complexes = unifyComplex(toUnify);
+        complexes = memoize ? cache.unifyComplex(toUnify)
+          : Sass::unifyComplex(toUnify);
         if (complexes.empty()) {
           return {};
         }
@@ -1046,6 +1084,30 @@ namespace Sass {
   }
   // EO rotateSlice
 
+  // ##########################################################################
+  // What [trim] computes once per selector, since it compares all pairs.
+  // ##########################################################################
+  struct TrimInfo {
+    size_t minSpecificity;
+    SuperselectorSignature signature;
+  };
+
+  // ##########################################################################
+  // Returns whether [complex2] keeps [complex1] from being trimmed.
+  // ##########################################################################
+  static bool dontTrimComplex(
+    const ComplexSelector* complex2,
+    const TrimInfo& info2,
+    const ComplexSelector* complex1,
+    const TrimInfo& info1,
+    const size_t maxSpecificity)
+  {
+    if (info2.minSpecificity < maxSpecificity) return false;
+    if (!info2.signature.mayBeSuperselectorOf(info1.signature)) return false;
+    return complex2->isSuperselectorOf(complex1);
+  }
+  // EO dontTrimComplex
+
   // ##########################################################################
   // Removes elements from [selectors] if they're subselectors of other
   // elements. The [isOriginal] callback indicates which selectors are
@@ -1071,6 +1133,15 @@ namespace Sass {
     // the result so that, if two selectors are identical, we keep the first one.
     sass::vector<ComplexSelectorObj> result; size_t numOriginals = 0;
 
+    // The minimum specificities and signatures of [selectors] and of
+    // [result] (kept in the same order), every pair compared needs them.
+    sass::vector<TrimInfo> infos;
+    infos.reserve(selectors.size());
+    for (const ComplexSelectorObj& complex : selectors) {
+      infos.push_back({ complex->minSpecificity(), superselectorSignature(complex) });
+    }
+    sass::vector<TrimInfo> resultInfos;
+
     size_t i = selectors.size();
   outer: // Use label to continue loop
     while (--i != sass::string::npos) {
@@ -1084,10 +1155,13 @@ namespace Sass {
         for (size_t j = 0; j < numOriginals; j++) {
           if (ObjEqualityFn(result[j], complex1)) {
             rotateSlice(result, 0, j + 1);
+            std::rotate(resultInfos.begin(),
+              resultInfos.begin() + j, resultInfos.begin() + j + 1);
             goto outer;
           }
         }
         result.insert(result.begin(), complex1);
+        resultInfos.insert(resultInfos.begin(), infos[i]);
         numOriginals++;
         continue;
       }
@@ -1107,19 +1181,24 @@ namespace Sass {
       // Look in [result] rather than [selectors] for selectors after [i]. This
       // ensures we aren't comparing against a selector that's already been trimmed,
       // and thus that if there are two identical selectors only one is trimmed.
-      if (hasAny(result, dontTrimComplex, complex1, maxSpecificity)) {
-        continue;
+      for (size_t j = 0; j < result.size(); j++) {
+        if (dontTrimComplex(result[j], resultInfos[j], complex1, infos[i], maxSpecificity)) {
+          goto outer;
+        }
       }
 
       // Check if any element (up to [i]) from [selector] returns true
       // when passed to [dontTrimComplex]. The arguments [complex1] and
       // [maxSepcificity] will be passed to the invoked function.
-      if (hasSubAny(selectors, i, dontTrimComplex, complex1, maxSpecificity)) {
-        continue;
+      for (size_t j = 0; j < i; j++) {
+        if (dontTrimComplex(selectors[j], infos[j], complex1, infos[i], maxSpecificity)) {
+          goto outer;
+        }
       }
 
       // ToDo: Maybe use deque for front insert?
       result.insert(result.begin(), complex1);
+      resultInfos.insert(resultInfos.begin(), infos[i]);
 
     }
 
@@ -1153,19 +1232,6 @@ namespace Sass {
   }
   // EO maxSourceSpecificity(CompoundSelectorObj)
 
-  // ##########################################################################
-  // Helper function used as callbacks on lists
-  // ##########################################################################
-  bool Extender::dontTrimComplex(
-    const ComplexSelector* complex2,
-    const ComplexSelector* complex1,
-    const size_t maxSpecificity)
-  {
-    if (complex2->minSpecificity() < maxSpecificity) return false;
-    return complex2->isSuperselectorOf(complex1);
-  }
-  // EO dontTrimComplex
-
   // ##########################################################################
   // Helper function used as callbacks on lists
   // ##########################################################################
@@ -11,6 +11,7 @@
 #include "extension.hpp"
 #include "backtrace.hpp"
 #include "ordered_map.hpp"
+#include "extender_cache.hpp"
 
 namespace Sass {
 
@@ -31,7 +32,8 @@ namespace Sass {
     ObjEquality
   > ExtSmplSelSet;
 
-  typedef std::unordered_set<
+  // Insertion ordered, so rules are extended in a stable order
+  typedef ordered_set<
     SelectorListObj,
     ObjPtrHash,
     ObjPtrEquality
@@ -138,6 +140,29 @@ namespace Sass {
     // ##########################################################################
     ExtCplxSelSet originals;
 
+    // ##########################################################################
+    // The complex selectors [extensionForSimple] wraps simple selectors in,
+    // one per simple selector instance (so they keep its source span). The
+    // same simple selector is extended over and over, and all extensions
+    // share its wrapper instead of allocating a new one every time.
+    // ##########################################################################
+    mutable std::unordered_map<
+      SimpleSelectorObj,
+      ComplexSelectorObj,
+      ObjPtrHash,
+      ObjPtrEquality
+    > wrappedSimples;
+
+    // ##########################################################################
+    // Memoized unifications (see ExtenderCache).
+    // Mutable since they are called from const member functions.
+    // ##########################################################################
+    mutable ExtenderCache cache;
+
+    // Off for the one-off extenders of the selector functions,
+    // which don't repeat unifications often enough to gain.
+    bool memoize;
+
   public:
 
     // Constructor without default [mode].
@@ -197,6 +222,14 @@ namespace Sass {
       const SelectorListObj& list,
       const SelectorListObj& rule);
 
+    // ##########################################################################
+    // Registers the [SimpleSelector]s in [complex]
+    // to point to [rule] in [selectors].
+    // ##########################################################################
+    void registerComplex(
+      const ComplexSelectorObj& complex,
+      const SelectorListObj& rule);
+
     // ##########################################################################
     // Adds an extension to this extender. The [extender] is the selector for the
     // style rule in which the extension is defined, and [target] is the selector
@@ -227,6 +260,11 @@ namespace Sass {
     bool checkForUnsatisfiedExtends(
       Extension& unsatisfied) const;
 
+    // ##########################################################################
+    // Hit rates of the memoized selector functions (one line each).
+    // ##########################################################################
+    sass::string cacheReport() const { return cache.report(); }
+
   private:
 
     // ##########################################################################
@@ -378,14 +416,6 @@ namespace Sass {
     // ##########################################################################
     size_t maxSourceSpecificity(const CompoundSelectorObj& compound) const;
 
-    // ##########################################################################
-    // Helper function used as callbacks on lists
-    // ##########################################################################
-    static bool dontTrimComplex(
-      const ComplexSelector* complex2,
-      const ComplexSelector* complex1,
-      const size_t maxSpecificity);
-
     // ##########################################################################
     // Helper function used as callbacks on lists
     // ##########################################################################
@@ -0,0 +1,195 @@
+// sass.hpp must go before all system headers to get the
+// __EXTENSIONS__ fix on Solaris.
+#include "sass.hpp"
+
+#include <sstream>
+#include <iomanip>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "ast.hpp"
+#include "extender_cache.hpp"
+
+namespace Sass {
+
+  // ##########################################################################
+  // Stricter than `operator==`, which ignores the order of simple selectors
+  // and line breaks. Both show up in the output of `weave` and `unifyComplex`.
+  // ##########################################################################
+  static bool sameComponent(
+    const SelectorComponent* lhs,
+    const SelectorComponent* rhs)
+  {
+    if (lhs == rhs) return true;
+    if (lhs->hash() != rhs->hash()) return false;
+    if (lhs->hasPostLineBreak() != rhs->hasPostLineBreak()) return false;
+    const CompoundSelector* lhs_compound = lhs->getCompound();
+    const CompoundSelector* rhs_compound = rhs->getCompound();
+    if (lhs_compound == nullptr || rhs_compound == nullptr) return *lhs == *rhs;
+    if (lhs_compound->hasRealParent() != rhs_compound->hasRealParent()) return false;
+    if (lhs_compound->length() != rhs_compound->length()) return false;
+    for (size_t i = 0; i < lhs_compound->length(); i += 1) {
+      const SimpleSelectorObj& lhs_simple = lhs_compound->get(i);
+      const SimpleSelectorObj& rhs_simple = rhs_compound->get(i);
+      if (lhs_simple == rhs_simple) continue;
+      if (!ObjEqualityFn(lhs_simple, rhs_simple)) return false;
+    }
+    return true;
+  }
+
+  static bool sameComponents(
+    const sass::vector<SelectorComponentObj>& lhs,
+    const sass::vector<SelectorComponentObj>& rhs)
+  {
+    if (lhs.size() != rhs.size()) return false;
+    for (size_t i = 0; i < lhs.size(); i += 1) {
+      if (!sameComponent(lhs[i], rhs[i])) return false;
+    }
+    return true;
+  }
+
+  double ExtenderCache::Counter::hitRate() const
+  {
+    return lookups == 0 ? 0.0 : double(hits) / double(lookups);
+  }
+
+  static size_t hashComplexList(const ExtenderCache::ComplexList& list)
+  {
+    size_t hash = list.size();
+    for (const sass::vector<SelectorComponentObj>& complex : list) {
+      hash_combine(hash, complex.size());
+      for (const SelectorComponentObj& component : complex) {
+        hash_combine(hash, component->hash());
+      }
+    }
+    return hash;
+  }
+
+  static bool sameComplexLists(
+    const ExtenderCache::ComplexList& lhs,
+    const ExtenderCache::ComplexList& rhs)
+  {
+    if (lhs.size() != rhs.size()) return false;
+    for (size_t i = 0; i < lhs.size(); i += 1) {
+      if (!sameComponents(lhs[i], rhs[i])) return false;
+    }
+    return true;
+  }
+
+  // Calls [fn] with each simple selector of [complexes], in order
+  template <class F>
+  static void eachSimple(const ExtenderCache::ComplexList& complexes, F fn)
+  {
+    for (const sass::vector<SelectorComponentObj>& complex : complexes) {
+      for (const SelectorComponentObj& component : complex) {
+        if (const CompoundSelector* compound = component->getCompound()) {
+          for (const SimpleSelectorObj& simple : compound->elements()) fn(simple);
+        }
+      }
+    }
+  }
+
+  // ##########################################################################
+  // Only results that can be remapped are cached: every simple selector in
+  // [result] must be one of [complexes]. Unification copies some of them
+  // (e.g. when unifying with a universal selector), and those copies would
+  // keep the source spans of the first call.
+  // ##########################################################################
+  static bool remappable(
+    const ExtenderCache::ComplexList& complexes,
+    const ExtenderCache::ComplexList& result)
+  {
+    std::unordered_set<const SimpleSelector*> simples;
+    eachSimple(complexes, [&simples](const SimpleSelectorObj& simple) {
+      simples.insert(simple.ptr());
+    });
+    bool known = true;
+    eachSimple(result, [&simples, &known](const SimpleSelectorObj& simple) {
+      known = known && simples.count(simple.ptr()) != 0;
+    });
+    return known;
+  }
+
+  // ##########################################################################
+  // The cached result contains selectors it was computed from. Swap them for
+  // the equal ones passed now, since they carry the source spans the caller
+  // expects (e.g. for source maps). Components are swapped as a whole, the
+  // compounds unification built get copied with the simple selectors swapped.
+  // ##########################################################################
+  ExtenderCache::ComplexList ExtenderCache::remap(
+    const ComplexList& cached, const ComplexList& complexes,
+    const ComplexList& result)
+  {
+    std::unordered_map<const SelectorComponent*, SelectorComponentObj> components;
+    for (size_t i = 0; i < cached.size(); i += 1) {
+      for (size_t n = 0; n < cached[i].size(); n += 1) {
+        if (cached[i][n] != complexes[i][n]) {
+          components[cached[i][n].ptr()] = complexes[i][n];
+        }
+      }
+    }
+    // the keys are equal, so their simple selectors pair up in order
+    sass::vector<SimpleSelectorObj> passed;
+    eachSimple(complexes, [&passed](const SimpleSelectorObj& simple) {
+      passed.push_back(simple);
+    });
+    std::unordered_map<const SimpleSelector*, SimpleSelectorObj> simples;
+    size_t index = 0;
+    eachSimple(cached, [&simples, &passed, &index](const SimpleSelectorObj& simple) {
+      if (simple != passed[index]) simples[simple.ptr()] = passed[index];
+      index += 1;
+    });
+
+    ComplexList remapped(result);
+    if (components.empty() && simples.empty()) return remapped;
+    for (sass::vector<SelectorComponentObj>& complex : remapped) {
+      for (SelectorComponentObj& component : complex) {
+        auto swapped = components.find(component.ptr());
+        if (swapped != components.end()) {
+          component = swapped->second;
+          continue;
+        }
+        CompoundSelector* compound = component->getCompound();
+        if (compound == nullptr) continue;
+        CompoundSelectorObj copy;
+        for (size_t i = 0; i < compound->length(); i += 1) {
+          auto simple = simples.find(compound->get(i).ptr());
+          if (simple == simples.end()) continue;
+          if (copy.isNull()) copy = SASS_MEMORY_COPY(compound);
+          copy->elements()[i] = simple->second;
+        }
+        if (!copy.isNull()) component = copy;
+      }
+    }
+    return remapped;
+  }
+
+  ExtenderCache::ComplexList ExtenderCache::unifyComplex(const ComplexList& complexes)
+  {
+    unification.lookups += 1;
+    size_t hash = hashComplexList(complexes);
+    auto cached = unified.find(complexes, hash, sameComplexLists);
+    if (cached != nullptr) {
+      unification.hits += 1;
+      return remap(cached->key, complexes, cached->value);
+    }
+    ComplexList result = Sass::unifyComplex(complexes);
+    if (remappable(complexes, result)) {
+      unified.insert(complexes, result, hash);
+    }
+    return result;
+  }
+
+  sass::string ExtenderCache::report() const
+  {
+    sass::sstream out;
+    out << std::fixed << std::setprecision(1);
+    auto line = [&out](const char* name, const Counter& counter) {
+      out << name << ": " << counter.hits << " of " << counter.lookups
+        << " lookups cached (" << counter.hitRate() * 100 << "%)\n";
+    };
+    line("unifyComplex", unification);
+    return out.str();
+  }
+
+}
@@ -0,0 +1,100 @@
+#ifndef SASS_EXTENDER_CACHE_H
+#define SASS_EXTENDER_CACHE_H
+
+// sass.hpp must go before all system headers to get the
+// __EXTENSIONS__ fix on Solaris.
+#include "sass.hpp"
+
+#include <cstdint>
+#include "ast_fwd_decl.hpp"
+
+namespace Sass {
+
+  // ##########################################################################
+  // Memoizes `unifyComplex`, which the extender calls over and over with
+  // equal selectors (once per extension of every extended compound). The
+  // result only depends on the selectors passed, so entries are keyed by
+  // the selector hashes and confirmed by comparing them. One cache belongs
+  // to one extender and thus lives for one compilation.
+  // ##########################################################################
+  class ExtenderCache {
+
+  public:
+
+    typedef sass::vector<sass::vector<SelectorComponentObj>> ComplexList;
+
+    // Lookups and hits of one memo table
+    struct Counter {
+      size_t lookups = 0;
+      size_t hits = 0;
+      double hitRate() const;
+    };
+
+    Counter unification;
+
+    // Same as the global `unifyComplex(complexes)`
+    ComplexList unifyComplex(const ComplexList& complexes);
+
+    // Hit rates of all tables, one line each
+    sass::string report() const;
+
+  private:
+
+    // ##########################################################################
+    // A table with a fixed number of slots, where a new entry replaces
+    // the one in its slot. The cached function is not slow enough to
+    // pay for the cache misses of a big hash map, and the memory used
+    // stays bounded for huge stylesheets. The slots are allocated on
+    // the first insert, since the short-lived extenders of functions
+    // like `selector-extend` usually never insert anything.
+    // ##########################################################################
+    template <class K, class V, size_t SLOTS>
+    class Table {
+    public:
+      struct Slot {
+        size_t hash = 0;
+        bool used = false;
+        K key;
+        V value;
+      };
+    private:
+      sass::vector<Slot> slots;
+      Slot& slot(size_t hash)
+      {
+        // fibonacci hashing, so all bits of the hash are used
+        uint64_t mixed = uint64_t(hash) * 11400714819323198485ull;
+        return slots[size_t(mixed >> 32) & (SLOTS - 1)];
+      }
+    public:
+      // Returns null if [key] is not cached
+      template <class E>
+      const Slot* find(const K& key, size_t hash, E equal)
+      {
+        if (slots.empty()) return nullptr;
+        const Slot& entry = slot(hash);
+        if (!entry.used || entry.hash != hash) return nullptr;
+        return equal(entry.key, key) ? &entry : nullptr;
+      }
+      void insert(const K& key, const V& value, size_t hash)
+      {
+        if (slots.empty()) slots.resize(SLOTS);
+        Slot& entry = slot(hash);
+        entry.hash = hash;
+        entry.used = true;
+        entry.key = key;
+        entry.value = value;
+      }
+    };
+
+    typedef Table<ComplexList, ComplexList, 1 << 12> ComplexListTable;
+
+    ComplexListTable unified;
+
+    static ComplexList remap(const ComplexList& cached,
+      const ComplexList& complexes, const ComplexList& result);
+
+  };
+
+}
+
+#endif
@@ -11,13 +11,16 @@
 # include <direct.h>
 # define S_ISDIR(mode) (((mode) & S_IFMT) == S_IFDIR)
 #else
+# include <fcntl.h>
 # include <unistd.h>
+# include <sys/mman.h>
 #endif
 #include <cstdio>
 #include <vector>
 #include <algorithm>
 #include <sys/stat.h>
 #include "file.hpp"
+#include "file_index.hpp"
 #include "context.hpp"
 #include "prelexer.hpp"
 #include "utf8_string.hpp"
@@ -101,6 +104,33 @@ namespace Sass {
       #endif
     }
 
+    // get the last modification time of the file
+    // returns false if the file can't be found
+    bool modification_time(const sass::string& path, int64_t& mtime)
+    {
+      #ifdef _WIN32
+        wchar_t resolved[32768];
+        // windows unicode filepaths are encoded in utf16
+        sass::string abspath(join_paths(get_cwd(), path));
+        if (!(abspath[0] == '/' && abspath[1] == '/')) {
+          abspath = "//?/" + abspath;
+        }
+        std::wstring wpath(UTF_8::convert_to_utf16(abspath));
+        std::replace(wpath.begin(), wpath.end(), '/', '\\');
+        DWORD rv = GetFullPathNameW(wpath.c_str(), 32767, resolved, NULL);
+        if (rv == 0 || rv > 32767) return false;
+        WIN32_FILE_ATTRIBUTE_DATA data;
+        if (!GetFileAttributesExW(resolved, GetFileExInfoStandard, &data)) return false;
+        mtime = (int64_t(data.ftLastWriteTime.dwHighDateTime) << 32) | data.ftLastWriteTime.dwLowDateTime;
+        return true;
+      #else
+        struct stat st_buf;
+        if (stat(path.c_str(), &st_buf) != 0) return false;
+        mtime = int64_t(st_buf.st_mtime);
+        return true;
+      #endif
+    }
+
     // return if given path is absolute
     // works with *nix and windows paths
     bool is_absolute_path(const sass::string& path)
@@ -326,6 +356,12 @@ namespace Sass {
       return result;
     }
 
+    // test if path is a file (via index if given)
+    static bool file_exists(const sass::string& path, DirectoryIndex* index)
+    {
+      return index ? index->file_exists(path) : file_exists(path);
+    }
+
     // Resolution order for ambiguous imports:
     // (1) filename as given
     // (2) underscore + given
@@ -333,7 +369,7 @@ namespace Sass {
     // (4) given + extension
     // (5) given + _index.scss
     // (6) given + _index.sass
-    sass::vector<Include> resolve_includes(const sass::string& root, const sass::string& file, const sass::vector<sass::string>& exts)
+    sass::vector<Include> resolve_includes(const sass::string& root, const sass::string& file, const sass::vector<sass::string>& exts, DirectoryIndex* index)
     {
       sass::string filename = join_paths(root, file);
       // split the filename
@@ -343,22 +379,22 @@ namespace Sass {
       // create full path (maybe relative)
       sass::string rel_path(join_paths(base, name));
       sass::string abs_path(join_paths(root, rel_path));
-      if (file_exists(abs_path)) includes.push_back({{ rel_path, root }, abs_path });
+      if (file_exists(abs_path, index)) includes.push_back({{ rel_path, root }, abs_path });
       // next test variation with underscore
       rel_path = join_paths(base, "_" + name);
       abs_path = join_paths(root, rel_path);
-      if (file_exists(abs_path)) includes.push_back({{ rel_path, root }, abs_path });
+      if (file_exists(abs_path, index)) includes.push_back({{ rel_path, root }, abs_path });
       // next test exts plus underscore
       for(auto ext : exts) {
         rel_path = join_paths(base, "_" + name + ext);
         abs_path = join_paths(root, rel_path);
-        if (file_exists(abs_path)) includes.push_back({{ rel_path, root }, abs_path });
+        if (file_exists(abs_path, index)) includes.push_back({{ rel_path, root }, abs_path });
       }
       // next test plain name with exts
       for(auto ext : exts) {
         rel_path = join_paths(base, name + ext);
         abs_path = join_paths(root, rel_path);
-        if (file_exists(abs_path)) includes.push_back({{ rel_path, root }, abs_path });
+        if (file_exists(abs_path, index)) includes.push_back({{ rel_path, root }, abs_path });
       }
       // index files
       if (includes.size() == 0) {
@@ -370,13 +406,13 @@ namespace Sass {
         for(auto ext : exts) {
           rel_path = join_paths(base, join_paths(name, "_index" + ext));
           abs_path = join_paths(root, rel_path);
-          if (file_exists(abs_path)) includes.push_back({{ rel_path, root }, abs_path });
+          if (file_exists(abs_path, index)) includes.push_back({{ rel_path, root }, abs_path });
         }
         // next test plain index exts
         for(auto ext : exts) {
           rel_path = join_paths(base, join_paths(name, "index" + ext));
           abs_path = join_paths(root, rel_path);
-          if (file_exists(abs_path)) includes.push_back({{ rel_path, root }, abs_path });
+          if (file_exists(abs_path, index)) includes.push_back({{ rel_path, root }, abs_path });
         }
       }
       // nothing found
@@ -429,11 +465,20 @@ namespace Sass {
       return sass::string("");
     }
 
+    // files smaller than this are always copied
+    // mapping them costs more than it saves
+    static const size_t MAP_THRESHOLD = 64 * 1024;
+
     // try to load the given filename
-    // returned memory must be freed
+    // maps it into memory if [mapped] is given
     // will auto convert .sass files
-    char* read_file(const sass::string& path)
+    static char* load_file(const sass::string& path, size_t* mapped)
     {
+      sass::string extension;
+      if (path.length() > 5) {
+        extension = path.substr(path.length() - 5, 5);
+      }
+      Util::ascii_str_tolower(&extension);
       #ifdef _WIN32
         BYTE* pBuffer;
         DWORD dwBytes;
@@ -469,9 +514,27 @@ namespace Sass {
         // https://github.com/sass/sassc-ruby/issues/128
         struct stat st;
         if (stat(path.c_str(), &st) == -1 || S_ISDIR(st.st_mode)) return 0;
+        const std::size_t size = st.st_size;
+        // the kernel fills the last page of the mapping with zeros, which
+        // gives us the two null chars the lexer needs after the contents
+        // unless the file ends right at (or one byte before) a page end
+        const std::size_t page = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+        if (mapped && size >= MAP_THRESHOLD && size % page != 0
+          && size % page <= page - 2 && extension != ".sass")
+        {
+          int fh = open(path.c_str(), O_RDONLY);
+          if (fh != -1) {
+            void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fh, 0);
+            close(fh);
+            if (data != MAP_FAILED) {
+              *mapped = size;
+              return static_cast<char*>(data);
+            }
+          }
+          // otherwise read it as usual
+        }
         FILE* fd = std::fopen(path.c_str(), "rb");
         if (fd == nullptr) return nullptr;
-        const std::size_t size = st.st_size;
         char* contents = static_cast<char*>(malloc(st.st_size + 2 * sizeof(char)));
         if (std::fread(static_cast<void*>(contents), 1, size, fd) != size) {
           free(contents);
@@ -485,11 +548,6 @@ namespace Sass {
         contents[size] = '\0';
         contents[size + 1] = '\0';
       #endif
-      sass::string extension;
-      if (path.length() > 5) {
-        extension = path.substr(path.length() - 5, 5);
-      }
-      Util::ascii_str_tolower(&extension);
       if (extension == ".sass" && contents != 0) {
         char * converted = sass2scss(contents, SASS2SCSS_PRETTIFY_1 | SASS2SCSS_KEEP_COMMENT);
         free(contents); // free the indented contents
@@ -499,6 +557,35 @@ namespace Sass {
       }
     }
 
+    // try to load the given filename
+    // returned memory must be freed
+    // will auto convert .sass files
+    char* read_file(const sass::string& path)
+    {
+      return load_file(path, nullptr);
+    }
+
+    // try to load the given filename
+    // big files are mapped into memory
+    // will auto convert .sass files
+    char* read_file(const sass::string& path, size_t& mapped)
+    {
+      mapped = 0;
+      return load_file(path, &mapped);
+    }
+
+    // release memory returned by `read_file`
+    void free_file(char* contents, size_t mapped)
+    {
+      #ifndef _WIN32
+        if (mapped) {
+          munmap(contents, mapped);
+          return;
+        }
+      #endif
+      free(contents);
+    }
+
     // split a path string delimited by semicolons or colons (OS dependent)
     sass::vector<sass::string> split_path_list(const char* str)
     {
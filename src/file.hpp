@@ -5,6 +5,7 @@
 // __EXTENSIONS__ fix on Solaris.
 #include "sass.hpp"
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -22,6 +23,10 @@ namespace Sass {
     // test if path exists and is a file
     bool file_exists(const sass::string& file);
 
+    // get the last modification time of the file
+    // returns false if the file can't be found
+    bool modification_time(const sass::string& file, int64_t& mtime);
+
     // return if given path is absolute
     // works with *nix and windows paths
     bool is_absolute_path(const sass::string& path);
@@ -68,6 +73,17 @@ namespace Sass {
     // will auto convert .sass files
     char* read_file(const sass::string& file);
 
+    // try to load the given filename
+    // big files are mapped into memory (on posix)
+    // sets [mapped] to the length of the mapping
+    // the file must not be truncated while in use
+    // returned memory must be released by `free_file`
+    // will auto convert .sass files
+    char* read_file(const sass::string& file, size_t& mapped);
+
+    // release memory returned by `read_file`
+    void free_file(char* contents, size_t mapped);
+
   }
 
   // requested import
@@ -93,9 +109,12 @@ namespace Sass {
     public:
       // resolved absolute path
       sass::string abs_path;
+      // import path as written in the stylesheet
+      // (`imp_path` is the one of the resolved file)
+      sass::string load_path;
     public:
       Include(const Importer& imp, sass::string abs_path)
-      : Importer(imp), abs_path(abs_path)
+      : Importer(imp), abs_path(abs_path), load_path(imp.imp_path)
       { }
   };
 
@@ -106,18 +125,27 @@ namespace Sass {
       char* contents;
       // connected sourcemap
       char* srcmap;
+      // length of the mapping if the contents
+      // are mapped from a file, zero if malloced
+      size_t mapped;
+      // contents are read from the file system
+      bool from_file;
     public:
-      Resource(char* contents, char* srcmap)
-      : contents(contents), srcmap(srcmap)
+      Resource(char* contents, char* srcmap, size_t mapped = 0, bool from_file = false)
+      : contents(contents), srcmap(srcmap), mapped(mapped), from_file(from_file)
       { }
   };
 
   namespace File {
 
-    static sass::vector<sass::string> defaultExtensions = { ".scss", ".sass", ".css" };
+    class DirectoryIndex;
+
+    static const sass::vector<sass::string> defaultExtensions = { ".scss", ".sass", ".css" };
 
+    // probes the candidates on disk or
+    // via the given index (if not null)
     sass::vector<Include> resolve_includes(const sass::string& root, const sass::string& file,
-      const sass::vector<sass::string>& exts = defaultExtensions);
+      const sass::vector<sass::string>& exts = defaultExtensions, DirectoryIndex* index = nullptr);
 
   }
 
@@ -0,0 +1,205 @@
+// sass.hpp must go before all system headers to get the
+// __EXTENSIONS__ fix on Solaris.
+#include "sass.hpp"
+
+#ifdef _WIN32
+# include <windows.h>
+#else
+# include <dirent.h>
+# include <sys/stat.h>
+#endif
+#include <ctime>
+#include <mutex>
+#include <memory>
+#include <atomic>
+#include <cstdint>
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "file_index.hpp"
+#include "file.hpp"
+#include "util_string.hpp"
+#include "utf8_string.hpp"
+
+namespace Sass {
+
+  namespace File {
+
+    namespace {
+
+      // A directory as it was when we listed it,
+      // never changed once it is shared
+      struct Listing {
+        // regular files (or links to them)
+        std::unordered_set<sass::string> files;
+        // directory did exist
+        bool exists = false;
+        // modification time of the directory
+        int64_t mtime = 0;
+        // time when it was listed
+        int64_t listed = 0;
+      };
+
+      // The current listing of a directory
+      struct Entry {
+        std::shared_ptr<const Listing> listing;
+        // view that checked it last
+        size_t generation = 0;
+      };
+
+      // shared by all views, the mutex is only held to look up
+      // and swap entries, never while the file system is read
+      std::mutex mutex;
+      std::unordered_map<sass::string, Entry> listings;
+      std::atomic<size_t> generations(0);
+
+      // file systems are case insensitive there by default
+      sass::string key(const sass::string& name)
+      {
+        #if defined(_WIN32) || defined(__APPLE__)
+          sass::string folded(name);
+          Util::ascii_str_tolower(&folded);
+          return folded;
+        #else
+          return name;
+        #endif
+      }
+
+      #ifdef _WIN32
+      // windows unicode filepaths are encoded in utf16
+      std::wstring wide_path(const sass::string& path)
+      {
+        sass::string abspath(path);
+        if (!(abspath[0] == '/' && abspath[1] == '/')) {
+          abspath = "//?/" + abspath;
+        }
+        std::wstring wpath(UTF_8::convert_to_utf16(abspath));
+        std::replace(wpath.begin(), wpath.end(), '/', '\\');
+        return wpath;
+      }
+      #endif
+
+      // get modification time if path is a directory
+      bool stat_directory(const sass::string& dir, int64_t& mtime)
+      {
+        #ifdef _WIN32
+          WIN32_FILE_ATTRIBUTE_DATA data;
+          if (!GetFileAttributesExW(wide_path(dir).c_str(), GetFileExInfoStandard, &data)) return false;
+          if (!(data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)) return false;
+          int64_t ticks = (int64_t(data.ftLastWriteTime.dwHighDateTime) << 32)
+                        | data.ftLastWriteTime.dwLowDateTime;
+          // from 100ns since 1601 to seconds since 1970
+          mtime = ticks / 10000000 - INT64_C(11644473600);
+          return true;
+        #else
+          struct stat st;
+          if (stat(dir.c_str(), &st) != 0 || !S_ISDIR(st.st_mode)) return false;
+          mtime = st.st_mtime;
+          return true;
+        #endif
+      }
+
+      // collect the files of the directory
+      void list_directory(const sass::string& dir, Listing& listing)
+      {
+        #ifdef _WIN32
+          WIN32_FIND_DATAW data;
+          HANDLE handle = FindFirstFileW((wide_path(dir) + L"*").c_str(), &data);
+          if (handle == INVALID_HANDLE_VALUE) return;
+          do {
+            if (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) continue;
+            listing.files.insert(key(UTF_8::convert_from_utf16(data.cFileName)));
+          } while (FindNextFileW(handle, &data));
+          FindClose(handle);
+        #else
+          DIR* handle = opendir(dir.c_str());
+          if (handle == nullptr) return;
+          while (struct dirent* entry = readdir(handle)) {
+            sass::string name(entry->d_name);
+            #ifdef DT_DIR
+              if (entry->d_type == DT_DIR) continue;
+              if (entry->d_type == DT_REG) {
+                listing.files.insert(key(name));
+                continue;
+              }
+            #endif
+            // links and unknown types need a closer look
+            if (File::file_exists(dir + name)) listing.files.insert(key(name));
+          }
+          closedir(handle);
+        #endif
+      }
+
+      // take a fresh listing of the directory
+      std::shared_ptr<const Listing> refresh(const sass::string& dir)
+      {
+        std::shared_ptr<Listing> listing = std::make_shared<Listing>();
+        listing->listed = static_cast<int64_t>(std::time(nullptr));
+        listing->exists = stat_directory(dir, listing->mtime);
+        if (listing->exists) list_directory(dir, *listing);
+        return listing;
+      }
+
+      // check if the directory changed since it was listed
+      bool changed(const sass::string& dir, const Listing& listing)
+      {
+        int64_t mtime = 0;
+        bool exists = stat_directory(dir, mtime);
+        if (exists != listing.exists) return true;
+        if (!exists) return false;
+        // changes within the second of the
+        // listing would go unnoticed otherwise
+        return mtime != listing.mtime || mtime >= listing.listed;
+      }
+
+    }
+
+    DirectoryIndex::DirectoryIndex(enum Sass_Directory_Index mode, const sass::string& cwd)
+    : mode(mode), cwd(cwd), generation(++generations)
+    { }
+
+    bool DirectoryIndex::file_exists(const sass::string& path)
+    {
+      if (mode == SASS_DIRECTORY_INDEX_NONE) return File::file_exists(path);
+      // split into directory (with trailing slash) and name
+      size_t pos = path.find_last_of('/');
+      #ifdef _WIN32
+        size_t pos_w = path.find_last_of('\\');
+        if (pos_w != sass::string::npos && (pos == sass::string::npos || pos_w > pos)) pos = pos_w;
+      #endif
+      sass::string name(pos == sass::string::npos ? path : path.substr(pos + 1));
+      if (name.empty() || name == "." || name == "..") return File::file_exists(path);
+      sass::string dir(pos == sass::string::npos ? "" : path.substr(0, pos + 1));
+      if (!is_absolute_path(dir)) dir = cwd + dir;
+      std::shared_ptr<const Listing> listing;
+      bool check = false;
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        Entry& entry = listings[dir];
+        listing = entry.listing;
+        check = entry.generation != generation;
+        entry.generation = generation;
+      }
+      if (!listing || (check && mode == SASS_DIRECTORY_INDEX_MTIME && changed(dir, *listing))) {
+        // other threads may list the same directory meanwhile,
+        // the listing taken last is the one that is kept
+        listing = refresh(dir);
+        std::lock_guard<std::mutex> lock(mutex);
+        Entry& entry = listings[dir];
+        if (!entry.listing || entry.listing->listed <= listing->listed) {
+          entry.listing = listing;
+        }
+      }
+      return listing->files.count(key(name)) != 0;
+    }
+
+    void DirectoryIndex::clear()
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      listings.clear();
+    }
+
+  }
+
+}
@@ -0,0 +1,55 @@
+#ifndef SASS_FILE_INDEX_H
+#define SASS_FILE_INDEX_H
+
+// sass.hpp must go before all system headers to get the
+// __EXTENSIONS__ fix on Solaris.
+#include "sass.hpp"
+
+#include <string>
+
+#include "sass/context.h"
+
+namespace Sass {
+
+  namespace File {
+
+    // ##########################################################################
+    // Answers `file_exists` from cached directory listings. Resolving a single
+    // import probes a dozen names in every include path, with the index every
+    // directory is read once and all probes are lookups in its listing.
+    // Listings are shared by all compilations of the process. Every context
+    // has its own view, which decides when they are checked against the
+    // directory modification time (see `Sass_Directory_Index`).
+    // Names are compared case insensitive (ascii only) on windows and mac.
+    // ##########################################################################
+    class DirectoryIndex {
+
+      public:
+
+        DirectoryIndex(enum Sass_Directory_Index mode, const sass::string& cwd);
+
+        // test if path exists and is a file
+        bool file_exists(const sass::string& path);
+
+        // drop all listings (of all views)
+        static void clear();
+
+      private:
+
+        // how listings are used
+        enum Sass_Directory_Index mode;
+
+        // base for relative paths
+        sass::string cwd;
+
+        // listings last checked with another
+        // generation are checked again by us
+        size_t generation;
+
+    };
+
+  }
+
+}
+
+#endif
@@ -115,10 +115,11 @@ namespace Sass {
       if (l->empty()) error("argument `$list` of `" + sass::string(sig) + "` must not be empty", pstate, traces);
       double index = std::floor(n->value() < 0 ? l->length() + n->value() : n->value() - 1);
       if (index < 0 || index > l->length() - 1) error("index out of bounds for `" + sass::string(sig) + "`", pstate, traces);
-      List* result = SASS_MEMORY_NEW(List, pstate, l->length(), l->separator(), false, l->is_bracketed());
-      for (size_t i = 0, L = l->length(); i < L; ++i) {
-        result->append(((i == index) ? v : (*l)[i]));
-      }
+      List* result = SASS_MEMORY_NEW(List, pstate, 0, l->separator(), false, l->is_bracketed());
+      // shares the elements until one is replaced, which still copies
+      // the list once (the argument is a value that must not change)
+      result->concat(l);
+      result->set(static_cast<size_t>(index), v);
       return result;
     }
 
@@ -182,6 +183,8 @@ namespace Sass {
       List_Obj result = SASS_MEMORY_NEW(List, pstate, len, sep_val, false, is_bracketed);
       result->concat(l1);
       result->concat(l2);
+      // no need to evaluate it again
+      result->is_expanded(l1->is_expanded() && l2->is_expanded());
       return result.detach();
     }
 
@@ -220,6 +223,8 @@ namespace Sass {
       } else {
         result->append(v);
       }
+      // shares the elements with the input (if it is not changed)
+      result->is_expanded(l->is_expanded());
       return result;
     }
 
@@ -242,7 +247,7 @@ namespace Sass {
             Argument_Obj arg = (Argument*)(arglist->at(i).ptr()); // XXX
             arg->value(ith);
           } else {
-            (*arglist)[i] = ith;
+            arglist->set(i, ith);
           }
         }
         shortest = (i ? std::min(shortest, ith->length()) : ith->length());
@@ -69,23 +69,28 @@ namespace Sass {
       // concat not implemented for maps
       *result += m1;
       *result += m2;
+      // no need to evaluate it again
+      result->is_expanded(m1->is_expanded() && m2->is_expanded());
       return result;
     }
 
     Signature map_remove_sig = "map-remove($map, $keys...)";
     BUILT_IN(map_remove)
     {
-      bool remove;
       Map_Obj m = ARGM("$map", Map);
       List_Obj arglist = ARG("$keys", List);
+      // shares all entries that are kept
       Map* result = SASS_MEMORY_NEW(Map, pstate, 1);
+      *result += m;
       for (auto key : m->keys()) {
-        remove = false;
-        for (size_t j = 0, K = arglist->length(); j < K && !remove; ++j) {
-          remove = Operators::eq(key, arglist->value_at_index(j));
+        for (size_t j = 0, K = arglist->length(); j < K; ++j) {
+          if (Operators::eq(key, arglist->value_at_index(j))) {
+            result->erase(key);
+            break;
+          }
         }
-        if (!remove) *result << std::make_pair(key, m->at(key));
       }
+      result->is_expanded(m->is_expanded());
       return result;
     }
 
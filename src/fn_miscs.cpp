@@ -24,7 +24,8 @@ namespace Sass {
     {
       sass::string s = Util::normalize_underscores(unquote(ARG("$name", String_Constant)->value()));
 
-      if(d_env.has("$"+s)) {
+      Symbol name(Symbol::find("$"+s));
+      if(d_env.has(name)) {
         return SASS_MEMORY_NEW(Boolean, pstate, true);
       }
       else {
@@ -37,7 +38,8 @@ namespace Sass {
     {
       sass::string s = Util::normalize_underscores(unquote(ARG("$name", String_Constant)->value()));
 
-      if(d_env.has_global("$"+s)) {
+      Symbol name(Symbol::find("$"+s));
+      if(d_env.has_global(name)) {
         return SASS_MEMORY_NEW(Boolean, pstate, true);
       }
       else {
@@ -55,7 +57,8 @@ namespace Sass {
 
       sass::string name = Util::normalize_underscores(unquote(ss->value()));
 
-      if(d_env.has(name+"[f]")) {
+      Symbol full_name(Symbol::find(name+"[f]"));
+      if(d_env.has(full_name)) {
         return SASS_MEMORY_NEW(Boolean, pstate, true);
       }
       else {
@@ -68,7 +71,8 @@ namespace Sass {
     {
       sass::string s = Util::normalize_underscores(unquote(ARG("$name", String_Constant)->value()));
 
-      if(d_env.has(s+"[m]")) {
+      Symbol name(Symbol::find(s+"[m]"));
+      if(d_env.has(name)) {
         return SASS_MEMORY_NEW(Boolean, pstate, true);
       }
       else {
@@ -135,7 +139,9 @@ namespace Sass {
           args->append(SASS_MEMORY_NEW(Argument, pstate, expr));
         }
       }
-      Function_Call_Obj func = SASS_MEMORY_NEW(Function_Call, pstate, function, args);
+      Function_Call_Obj func = SASS_MEMORY_NEW(Function_Call, pstate, String_Obj{}, args);
+      // the name is only known now, look it up without interning
+      func->sname(SASS_MEMORY_NEW(String_Constant, pstate, function), false);
 
       Expand expand(ctx, &d_env, &selector_stack, &original_stack);
       func->via_call(true); // calc invoke is allowed
@@ -217,7 +223,7 @@ namespace Sass {
       }
 
       sass::string name = Util::normalize_underscores(unquote(ss->value()));
-      sass::string full_name = name + "[f]";
+      Symbol full_name(Symbol::find(name + "[f]"));
 
       Boolean_Obj css = ARG("$css", Boolean);
       if (!css->is_false()) {
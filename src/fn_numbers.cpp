@@ -5,6 +5,7 @@
 #include <cstdint>
 #include <cstdlib>
 #include <cmath>
+#include <mutex>
 #include <random>
 #include <sstream>
 #include <iomanip>
@@ -51,6 +52,16 @@ namespace Sass {
     // is exhausted. For practical use, random_device is
     // generally only used to seed a PRNG such as mt19937.
     static std::mt19937 rand(static_cast<unsigned int>(GetSeed()));
+    // the generator is shared by all compilations
+    // in the process, so access must be serialized
+    static std::mutex rand_mutex;
+
+    template <typename Distribution>
+    static double draw(Distribution& distributor)
+    {
+      std::lock_guard<std::mutex> lock(rand_mutex);
+      return distributor(rand);
+    }
 
     ///////////////////
     // NUMBER FUNCTIONS
@@ -165,12 +176,12 @@ namespace Sass {
           error(err.str(), pstate, traces);
         }
         std::uniform_real_distribution<> distributor(1, lv + 1);
-        uint_fast32_t distributed = static_cast<uint_fast32_t>(distributor(rand));
+        uint_fast32_t distributed = static_cast<uint_fast32_t>(draw(distributor));
         return SASS_MEMORY_NEW(Number, pstate, (double)distributed);
       }
       else if (b) {
         std::uniform_real_distribution<> distributor(0, 1);
-        double distributed = static_cast<double>(distributor(rand));
+        double distributed = static_cast<double>(draw(distributor));
         return SASS_MEMORY_NEW(Number, pstate, distributed);
       } else if (v) {
         traces.push_back(Backtrace(pstate));
@@ -186,7 +197,7 @@ namespace Sass {
     {
       sass::sstream ss;
       std::uniform_real_distribution<> distributor(0, 4294967296); // 16^8
-      uint_fast32_t distributed = static_cast<uint_fast32_t>(distributor(rand));
+      uint_fast32_t distributed = static_cast<uint_fast32_t>(draw(distributor));
       ss << "u" << std::setfill('0') << std::setw(8) << std::hex << distributed;
       return SASS_MEMORY_NEW(String_Quoted, pstate, ss.str());
     }
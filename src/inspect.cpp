@@ -14,6 +14,7 @@
 #include "context.hpp"
 #include "listize.hpp"
 #include "color_maps.hpp"
+#include "util_string.hpp"
 #include "utf8/checked.h"
 
 namespace Sass {
@@ -570,24 +571,18 @@ namespace Sass {
     // reduce units
     n->reduce();
 
-    sass::sstream ss;
-    ss.precision(opt.precision);
-    ss << std::fixed << n->value();
-
-    sass::string res = ss.str();
+    sass::string res = Util::format_fixed(n->value(), opt.precision);
     size_t s = res.length();
 
     // delete trailing zeros
     for(s = s - 1; s > 0; --s)
     {
-        if(res[s] == '0') {
-          res.erase(s, 1);
-        }
-        else break;
+        if(res[s] != '0') break;
     }
+    res.erase(s + 1);
 
     // delete trailing decimal separator
-    if(res[s] == '.') res.erase(s, 1);
+    if(res[s] == '.') res.erase(s);
 
     // some final cosmetics
     if (res == "0.0") res = "0";
@@ -624,11 +619,18 @@ namespace Sass {
     else                return c;
   }
 
+  // helpers for serializing colors as hex
+  static void append_hex_digit(sass::string& out, unsigned long digit) {
+    out += "0123456789abcdef"[digit & 0xf];
+  }
+
+  static void append_hex_byte(sass::string& out, unsigned long byte) {
+    append_hex_digit(out, byte >> 4);
+    append_hex_digit(out, byte);
+  }
+
   void Inspect::operator()(Color_RGBA* c)
   {
-    // output the final token
-    sass::sstream ss;
-
     // original color name
     // maybe an unknown token
     sass::string name = c->disp();
@@ -656,46 +658,47 @@ namespace Sass {
         res_name = color_to_name(numval);
     }
 
-    sass::sstream hexlet;
+    sass::string hexlet("#");
     // dart sass compressed all colors in regular css always
     // ruby sass and libsass does it only when not delayed
     // since color math is going to be removed, this can go too
     bool compressed = opt.output_style == COMPRESSED;
-    hexlet << '#' << std::setw(1) << std::setfill('0');
     // create a short color hexlet if there is any need for it
     if (compressed && is_color_doublet(r, g, b) && a == 1) {
-      hexlet << std::hex << std::setw(1) << (static_cast<unsigned long>(r) >> 4);
-      hexlet << std::hex << std::setw(1) << (static_cast<unsigned long>(g) >> 4);
-      hexlet << std::hex << std::setw(1) << (static_cast<unsigned long>(b) >> 4);
+      append_hex_digit(hexlet, static_cast<unsigned long>(r) >> 4);
+      append_hex_digit(hexlet, static_cast<unsigned long>(g) >> 4);
+      append_hex_digit(hexlet, static_cast<unsigned long>(b) >> 4);
     } else {
-      hexlet << std::hex << std::setw(2) << static_cast<unsigned long>(r);
-      hexlet << std::hex << std::setw(2) << static_cast<unsigned long>(g);
-      hexlet << std::hex << std::setw(2) << static_cast<unsigned long>(b);
+      append_hex_byte(hexlet, static_cast<unsigned long>(r));
+      append_hex_byte(hexlet, static_cast<unsigned long>(g));
+      append_hex_byte(hexlet, static_cast<unsigned long>(b));
     }
 
     if (compressed && !c->is_delayed()) name = "";
     if (opt.output_style == INSPECT && a >= 1) {
-      append_token(hexlet.str(), c);
+      append_token(hexlet, c);
       return;
     }
 
     // retain the originally specified color definition if unchanged
     if (name != "") {
-      ss << name;
+      append_token(name, c);
     }
     else if (a >= 1) {
       if (res_name != "") {
-        if (compressed && hexlet.str().size() < res_name.size()) {
-          ss << hexlet.str();
+        if (compressed && hexlet.size() < res_name.size()) {
+          append_token(hexlet, c);
         } else {
-          ss << res_name;
+          append_token(res_name, c);
         }
       }
       else {
-        ss << hexlet.str();
+        append_token(hexlet, c);
       }
     }
     else {
+      // output the final token
+      sass::sstream ss;
       ss << "rgba(";
       ss << static_cast<unsigned long>(r) << ",";
       if (!compressed) ss << " ";
@@ -704,10 +707,9 @@ namespace Sass {
       ss << static_cast<unsigned long>(b) << ",";
       if (!compressed) ss << " ";
       ss << a << ')';
+      append_token(ss.str(), c);
     }
 
-    append_token(ss.str(), c);
-
   }
 
   void Inspect::operator()(Color_HSLA* c)
@@ -1066,8 +1068,8 @@ namespace Sass {
     const SelectorComponent* prev = nullptr;
     for (auto& item : sel->elements()) {
       if (prev != nullptr) {
-        if (typeid(*item) == typeid(SelectorCombinator) ||
-            typeid(*prev) == typeid(SelectorCombinator)) {
+        if (Cast<SelectorCombinator>(item) ||
+            Cast<SelectorCombinator>(prev)) {
           append_optional_space();
         } else {
           append_mandatory_space();
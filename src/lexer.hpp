@@ -27,6 +27,9 @@ namespace Sass {
     // Matches ASCII digits, +, and -.
     bool is_number(char src);
 
+    // Matches alnum, non-ascii and hyphen.
+    bool is_character(char src);
+
     bool is_uri_character(char src);
     bool escapable_character(char src);
 
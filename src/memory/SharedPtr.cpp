@@ -13,11 +13,11 @@ namespace Sass {
 
   #ifdef DEBUG_SHARED_PTR
   void SharedObj::dumpMemLeaks() {
-    if (!all.empty()) {
+    if (all && !all->empty()) {
       std::cerr << "###################################\n";
       std::cerr << "# REPORTING MISSING DEALLOCATIONS #\n";
       std::cerr << "###################################\n";
-      for (SharedObj* var : all) {
+      for (SharedObj* var : *all) {
         if (AST_Node* ast = dynamic_cast<AST_Node*>(var)) {
           debug_ast(ast);
         } else {
@@ -25,9 +25,18 @@ namespace Sass {
         }
       }
     }
+    // nothing left to track on this thread
+    else if (all) {
+      delete all;
+      all = nullptr;
+    }
+  }
+  sass::vector<SharedObj*>& SharedObj::tracked() {
+    if (all == nullptr) all = new sass::vector<SharedObj*>();
+    return *all;
   }
-  sass::vector<SharedObj*> SharedObj::all;
+  SASS_THREAD_LOCAL sass::vector<SharedObj*>* SharedObj::all = nullptr;
   #endif
 
-  bool SharedObj::taint = false;
+  SASS_THREAD_LOCAL bool SharedObj::taint = false;
 }
@@ -4,6 +4,7 @@
 #include "sass/base.h"
 
 #include "../sass.hpp"
+#include "allocator.hpp"
 #include <cstddef>
 #include <iostream>
 #include <string>
@@ -19,8 +20,9 @@ namespace Sass {
   class SharedPtr;
 
   ///////////////////////////////////////////////////////////////////////////////
-  // Use macros for the allocation task, since overloading operator `new`
-  // has been proven to be flaky under certain compilers (see comment below).
+  // Use macros for the allocation task, since overloading global operator `new`
+  // has been proven to be flaky under certain compilers. We only overload it on
+  // the class level of `SharedObj` to route all nodes into the current arena.
   ///////////////////////////////////////////////////////////////////////////////
 
   #ifdef DEBUG_SHARED_PTR
@@ -59,16 +61,16 @@ namespace Sass {
   // object are allocated in one continuous memory block via one single call).
   class SharedObj {
    public:
-    SharedObj() : refcount(0), detached(false) {
+    SharedObj() : refcount(0), detached(false), immortal(false) {
       #ifdef DEBUG_SHARED_PTR
-      if (taint) all.push_back(this);
+      if (taint) tracked().push_back(this);
       #endif
     }
     virtual ~SharedObj() {
       #ifdef DEBUG_SHARED_PTR
-      for (size_t i = 0; i < all.size(); i++) {
-        if (all[i] == this) {
-          all.erase(all.begin() + i);
+      for (size_t i = 0; all && i < all->size(); i++) {
+        if ((*all)[i] == this) {
+          all->erase(all->begin() + i);
           break;
         }
       }
@@ -90,18 +92,35 @@ namespace Sass {
 
     static void setTaint(bool val) { taint = val; }
 
+    // Immortal objects are never deleted and their reference counter
+    // is left untouched. This allows to share them between threads
+    // (e.g. the built-in functions), as long as they are not mutated.
+    void makeImmortal() { immortal = true; }
+    bool isImmortal() const { return immortal; }
+
+    #ifdef SASS_ARENA_ALLOCATOR
+    // Nodes are allocated from the arena active on this thread
+    static void* operator new(size_t size) { return Memory::allocate(size); }
+    static void operator delete(void* ptr) { Memory::deallocate(ptr); }
+    #endif
+
     virtual sass::string to_string() const = 0;
    protected:
     friend class SharedPtr;
     friend class Memory_Manager;
     size_t refcount;
     bool detached;
-    static bool taint;
+    bool immortal;
+    // per thread, so concurrent compilations don't interfere
+    static SASS_THREAD_LOCAL bool taint;
     #ifdef DEBUG_SHARED_PTR
     sass::string file;
     size_t line;
     bool dbg = false;
-    static sass::vector<SharedObj*> all;
+    // created on first use, since `__declspec(thread)`
+    // can not hold objects with non-trivial constructors
+    static SASS_THREAD_LOCAL sass::vector<SharedObj*>* all;
+    static sass::vector<SharedObj*>& tracked();
     #endif
   };
 
@@ -124,7 +143,7 @@ namespace Sass {
         decRefCount();
         node = other_node;
         incRefCount();
-      } else if (node != nullptr) {
+      } else if (node != nullptr && !node->immortal) {
         node->detached = false;
       }
       return *this;
@@ -136,7 +155,7 @@ namespace Sass {
 
     // Prevents all SharedPtrs from freeing this node until it is assigned to another SharedPtr.
     SharedObj* detach() {
-      if (node != nullptr) node->detached = true;
+      if (node != nullptr && !node->immortal) node->detached = true;
       #ifdef DEBUG_SHARED_PTR
       if (node->dbg) {
         std::cerr << "DETACHING NODE\n";
@@ -153,7 +172,7 @@ namespace Sass {
    protected:
     SharedObj* node;
     void decRefCount() {
-      if (node == nullptr) return;
+      if (node == nullptr || node->immortal) return;
       --node->refcount;
       #ifdef DEBUG_SHARED_PTR
       if (node->dbg) std::cerr << "- " << node << " X " << node->refcount << " (" << this << ") " << "\n";
@@ -171,7 +190,7 @@ namespace Sass {
       }
     }
     void incRefCount() {
-      if (node == nullptr) return;
+      if (node == nullptr || node->immortal) return;
       node->detached = false;
       ++node->refcount;
       #ifdef DEBUG_SHARED_PTR
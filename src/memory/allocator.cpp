@@ -0,0 +1,164 @@
+#include "../sass.hpp"
+#include "allocator.hpp"
+
+#include <new>
+#include <cstring>
+
+namespace Sass {
+
+  namespace Memory {
+
+    // Every block is prefixed with this header, so we know
+    // where to return it to once the object is deleted.
+    struct Header {
+      // Owning arena (nullptr if allocated on the heap)
+      Arena* arena;
+      // Size class inside the arena
+      size_t bucket;
+    };
+
+    // Make sure the payload keeps the alignment
+    static const size_t header_size =
+      (sizeof(Header) + Arena::alignment - 1)
+        / Arena::alignment * Arena::alignment;
+
+    // The arena currently active on this thread
+    static SASS_THREAD_LOCAL Arena* current_arena = nullptr;
+
+    Arena::Arena()
+    : chunks(),
+      cursor(nullptr),
+      limit(nullptr),
+      foreign(nullptr),
+      live(1),
+      owned(true)
+    {
+      std::memset(free_lists, 0, sizeof(free_lists));
+    }
+
+    Arena::~Arena()
+    {
+      // Free all chunks in one go
+      for (char* chunk : chunks) {
+        ::operator delete(chunk);
+      }
+    }
+
+    Arena* Arena::create()
+    {
+      return new Arena();
+    }
+
+    void Arena::release()
+    {
+      if (current_arena == this) {
+        current_arena = nullptr;
+      }
+      owned = false;
+      if (live.fetch_sub(1, std::memory_order_acq_rel) == 1) delete this;
+    }
+
+    void Arena::reclaim()
+    {
+      void* block = foreign.exchange(nullptr, std::memory_order_acquire);
+      while (block != nullptr) {
+        void* next = *static_cast<void**>(block);
+        // the link only overwrote the arena of the header
+        size_t bucket = static_cast<Header*>(block)->bucket;
+        *static_cast<void**>(block) = free_lists[bucket];
+        free_lists[bucket] = block;
+        block = next;
+      }
+    }
+
+    void* Arena::allocate(size_t bucket)
+    {
+      live.fetch_add(1, std::memory_order_relaxed);
+      // Take over blocks released on other threads
+      if (free_lists[bucket] == nullptr &&
+          foreign.load(std::memory_order_relaxed) != nullptr) {
+        reclaim();
+      }
+      // Try to recycle a released block first
+      if (void* block = free_lists[bucket]) {
+        free_lists[bucket] = *static_cast<void**>(block);
+        return block;
+      }
+      size_t size = bucket * alignment;
+      // Start a new chunk if there is no more room
+      if (cursor == nullptr || size_t(limit - cursor) < size) {
+        char* chunk = static_cast<char*>(::operator new(chunk_size));
+        chunks.push_back(chunk);
+        cursor = chunk;
+        limit = chunk + chunk_size;
+      }
+      void* block = cursor;
+      cursor += size;
+      return block;
+    }
+
+    void Arena::deallocate(void* block, size_t bucket)
+    {
+      // Only the thread we are active on may use the free lists
+      if (current_arena == this) {
+        *static_cast<void**>(block) = free_lists[bucket];
+        free_lists[bucket] = block;
+      }
+      else {
+        void* head = foreign.load(std::memory_order_relaxed);
+        do {
+          *static_cast<void**>(block) = head;
+        } while (!foreign.compare_exchange_weak(head, block,
+          std::memory_order_release, std::memory_order_relaxed));
+      }
+      // The last one to let go (owner or block) frees the arena
+      if (live.fetch_sub(1, std::memory_order_acq_rel) == 1) delete this;
+    }
+
+    Arena* Arena::current()
+    {
+      return current_arena;
+    }
+
+    Arena* Arena::activate(Arena* arena)
+    {
+      Arena* previous = current_arena;
+      current_arena = arena;
+      return previous;
+    }
+
+    void* allocate(size_t size)
+    {
+      size_t total = size + header_size;
+      Arena* arena = current_arena;
+      size_t bucket = (total + Arena::alignment - 1) / Arena::alignment;
+      void* block = nullptr;
+      if (arena != nullptr && total <= Arena::max_size) {
+        block = arena->allocate(bucket);
+      }
+      else {
+        block = ::operator new(total);
+        arena = nullptr;
+      }
+      Header* header = static_cast<Header*>(block);
+      header->arena = arena;
+      header->bucket = bucket;
+      return static_cast<char*>(block) + header_size;
+    }
+
+    void deallocate(void* ptr)
+    {
+      if (ptr == nullptr) return;
+      void* block = static_cast<char*>(ptr) - header_size;
+      Header* header = static_cast<Header*>(block);
+      if (header->arena == nullptr) {
+        ::operator delete(block);
+      }
+      else {
+        header->arena->deallocate(block, header->bucket);
+      }
+    }
+
+  }
+
+}
@@ -0,0 +1,115 @@
+#ifndef SASS_MEMORY_ALLOCATOR_H
+#define SASS_MEMORY_ALLOCATOR_H
+
+#include "../sass.hpp"
+#include <atomic>
+#include <cstddef>
+
+///////////////////////////////////////////////////////////////////////////////
+// The arena allocator can be used for all `SharedObj` instances (AST nodes).
+// Each `Context` owns one arena, which is activated for the current thread
+// while the compiler is running. Nodes are bump allocated out of big chunks
+// and released nodes are recycled via per size-class free lists. The chunks
+// themselves are returned to the system in one go once the context and all
+// nodes still referencing the arena are gone. Nodes released on a thread
+// where their arena is not active (e.g. values handed out through the C-API)
+// go to a lock free list, which the owner takes over on its next allocation.
+// It is opt-in: define `SASS_ARENA_ALLOCATOR` to route the nodes into the
+// arena, otherwise they are plain heap allocations. It is always disabled
+// when `DEBUG_SHARED_PTR` is defined.
+///////////////////////////////////////////////////////////////////////////////
+
+#if defined(SASS_ARENA_ALLOCATOR) && defined(DEBUG_SHARED_PTR)
+#undef SASS_ARENA_ALLOCATOR
+#endif
+
+namespace Sass {
+
+  namespace Memory {
+
+    class Arena {
+
+    public:
+
+      // All allocations are padded to this alignment
+      static const size_t alignment = 16;
+      // Bigger allocations are passed to the heap
+      static const size_t max_size = 1024;
+      // Size of chunks we request from the heap
+      static const size_t chunk_size = 64 * 1024;
+      // Number of size classes we need to track
+      static const size_t buckets = max_size / alignment + 1;
+
+    private:
+
+      // Chunks we requested from the heap
+      sass::vector<char*> chunks;
+      // Bump pointer into the current chunk
+      char* cursor;
+      // End of the current chunk
+      char* limit;
+      // Singly linked lists of released blocks
+      void* free_lists[buckets];
+      // Blocks released where we were not active
+      std::atomic<void*> foreign;
+      // Blocks not yet returned to us, plus one while owned
+      std::atomic<size_t> live;
+      // Still owned by a context
+      bool owned;
+
+      // Move the blocks of `foreign` to the free lists
+      void reclaim();
+
+      Arena();
+      ~Arena();
+
+    public:
+
+      // Create a new arena owned by the caller
+      static Arena* create();
+
+      // Owner gives up the arena; it is destroyed
+      // once the last allocated block is released
+      void release();
+
+      // Get a block from the given size class
+      void* allocate(size_t bucket);
+
+      // Return a block to the given size class
+      void deallocate(void* ptr, size_t bucket);
+
+      // Number of blocks not yet released
+      size_t allocated() const { return live - (owned ? 1 : 0); }
+
+      // Number of bytes requested from the heap
+      size_t reserved() const { return chunks.size() * chunk_size; }
+
+      // Arena used by allocations on this thread
+      static Arena* current();
+
+      // Make the given arena current and return the previous one
+      static Arena* activate(Arena* arena);
+
+    };
+
+    // Activates an arena for the lifetime of this object
+    class ArenaScope {
+    private:
+      Arena* previous;
+    public:
+      ArenaScope(Arena* arena)
+      : previous(Arena::activate(arena)) {}
+      ~ArenaScope() { Arena::activate(previous); }
+    };
+
+    // Allocate from the current arena (or from the heap if none is active)
+    void* allocate(size_t size);
+
+    // Release memory returned by `allocate` (to whomever it belongs)
+    void deallocate(void* ptr);
+
+  }
+
+}
+
+#endif
@@ -107,6 +107,54 @@ namespace Sass {
 
   };
 
+  // ##########################################################################
+  // Very simple and limited container for insert ordered hash set.
+  // Piggy-back implementation on std::unordered_set and sass::vector
+  // ##########################################################################
+  template<
+    class Key,
+    class Hash = std::hash<Key>,
+    class KeyEqual = std::equal_to<Key>
+  >
+  class ordered_set {
+
+  private:
+
+    // The main unordered set
+    std::unordered_set<Key, Hash, KeyEqual> _set;
+
+    // Keep insertion order
+    sass::vector<Key> _keys;
+
+  public:
+
+    bool empty() const {
+      return _keys.empty();
+    }
+
+    size_t size() const {
+      return _keys.size();
+    }
+
+    bool insert(const Key& key) {
+      if (!_set.insert(key).second) return false;
+      _keys.push_back(key);
+      return true;
+    }
+
+    bool hasKey(const Key& key) const {
+      return _set.find(key) != _set.end();
+    }
+
+    const sass::vector<Key>& keys() const { return _keys; }
+
+    using const_iterator = typename sass::vector<Key>::const_iterator;
+
+    typename sass::vector<Key>::const_iterator end() const { return _keys.end(); }
+    typename sass::vector<Key>::const_iterator begin() const { return _keys.begin(); }
+
+  };
+
 }
 
 #endif
@@ -11,6 +11,7 @@ namespace Sass {
   Output::Output(Sass_Output_Options& opt)
   : Inspect(Emitter(opt)),
     charset(""),
+    preamble(""),
     top_nodes(0)
   {}
 
@@ -29,10 +30,9 @@ namespace Sass {
       // should be handle in check_expression
       throw Exception::InvalidValue({}, *n);
     }
-    // use values to_string facility
-    sass::string res = n->to_string(opt);
-    // output the final token
-    append_token(res, n);
+    // output the final token (formatted in place,
+    // no need for a separate emitter via to_string)
+    Inspect::operator()(n);
   }
 
   void Output::operator()(Import* imp)
@@ -46,7 +46,16 @@ namespace Sass {
     throw Exception::InvalidValue({}, *m);
   }
 
-  OutputBuffer Output::get_buffer(void)
+  static bool is_ascii(const sass::string& text)
+  {
+    for (const char& chr : text) {
+      // static cast to unsigned to handle `char` being signed / unsigned
+      if (static_cast<unsigned char>(chr) >= 128) return false;
+    }
+    return true;
+  }
+
+  OutputBuffer& Output::get_buffer(void)
   {
 
     Emitter emitter(opt);
@@ -61,30 +70,35 @@ namespace Sass {
     // flush scheduled outputs
     // maybe omit semicolon if possible
     inspect.finalize(wbuf.buffer.size() == 0);
-    // prepend buffer on top
-    prepend_output(inspect.output());
+    // put hoisted nodes on top
+    const OutputBuffer hoisted(inspect.output());
+    wbuf.smap.prepend(hoisted);
+    preamble = hoisted.buffer;
     // make sure we end with a linefeed
-    if (!ends_with(wbuf.buffer, opt.linefeed)) {
+    const sass::string& tail(wbuf.buffer.empty() ? preamble : wbuf.buffer);
+    if (!ends_with(tail, opt.linefeed)) {
       // if the output is not completely empty
-      if (!wbuf.buffer.empty()) append_string(opt.linefeed);
+      if (!tail.empty()) append_string(opt.linefeed);
     }
 
-    // search for unicode char
-    for(const char& chr : wbuf.buffer) {
-      // skip all ascii chars
-      // static cast to unsigned to handle `char` being signed / unsigned
-      if (static_cast<unsigned>(chr) < 128) continue;
+    // search for unicode char (also in the streamed output)
+    if (!is_ascii(preamble) || !streamed_ascii || !is_ascii(wbuf.buffer)) {
       // declare the charset
       if (output_style() != COMPRESSED)
         charset = "@charset \"UTF-8\";"
                 + sass::string(opt.linefeed);
       else charset = "\xEF\xBB\xBF";
-      // abort search
-      break;
     }
 
     // add charset as first line, before comments and imports
-    if (!charset.empty()) prepend_string(charset);
+    if (!charset.empty()) {
+      // do not adjust mappings for utf8 bom
+      // seems they are not counted in any UA
+      if (charset.compare("\xEF\xBB\xBF") != 0) {
+        wbuf.smap.prepend(Offset(charset));
+      }
+      preamble = charset + preamble;
+    }
 
     return wbuf;
 
@@ -21,10 +21,16 @@ namespace Sass {
 
   protected:
     sass::string charset;
+    sass::string preamble;
     sass::vector<AST_Node*> top_nodes;
 
   public:
-    OutputBuffer get_buffer(void);
+    // Finish the output and return its body. The hoisted
+    // charset and top nodes go in front of it, they are
+    // kept apart in [preamble] to not copy the whole body
+    // (the source map of the body already accounts for it).
+    OutputBuffer& get_buffer(void);
+    const sass::string& get_preamble(void) { return preamble; }
 
     virtual void operator()(Map*);
     virtual void operator()(StyleRule*);
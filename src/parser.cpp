@@ -2,6 +2,8 @@
 // __EXTENSIONS__ fix on Solaris.
 #include "sass.hpp"
 
+#include <cstring>
+
 #include "parser.hpp"
 #include "color_maps.hpp"
 #include "util_string.hpp"
@@ -201,6 +203,86 @@ namespace Sass {
     return true;
   }
 
+  // at-rules with their own parser in `parse_block_node`
+  enum class Directive {
+    None, Error, Debug, Warn, If, For, Each, While, Return, Import, Extend,
+    Media, AtRoot, Include, Content, Supports, Mixin, Function, Charset, Else, Other
+  };
+
+  // get the directive starting at `src` by scanning its name only
+  // once, instead of trying every keyword matcher one after another
+  static Directive directive_at(const char* src)
+  {
+    if (*src != '@') return Directive::None;
+    const char* name = src + 1;
+    const char* end = name;
+    while (is_character(*end)) ++ end;
+    size_t len = end - name;
+    // `@else` is matched without a word boundary
+    if (len >= 4 && std::memcmp(name, else_kwd + 1, 4) == 0) return Directive::Else;
+    // keywords are matched with a word boundary
+    if (*end == '#') return Directive::Other;
+    // compare against a keyword (without the `@`)
+    auto is = [name, len](const char* kwd) {
+      return std::strlen(kwd + 1) == len && std::memcmp(kwd + 1, name, len) == 0;
+    };
+    switch (*name) {
+      case 'a':
+        if (is(at_root_kwd)) return Directive::AtRoot;
+        break;
+      case 'c':
+        if (is(content_kwd)) return Directive::Content;
+        if (is(charset_kwd)) return Directive::Charset;
+        break;
+      case 'd':
+        if (is(debug_kwd)) return Directive::Debug;
+        break;
+      case 'e':
+        if (is(error_kwd)) return Directive::Error;
+        if (is(each_kwd)) return Directive::Each;
+        if (is(extend_kwd)) return Directive::Extend;
+        break;
+      case 'f':
+        if (is(for_kwd)) return Directive::For;
+        if (is(function_kwd)) return Directive::Function;
+        break;
+      case 'i':
+        if (is(if_kwd)) return Directive::If;
+        if (is(import_kwd)) return Directive::Import;
+        if (is(include_kwd)) return Directive::Include;
+        break;
+      case 'm':
+        if (is(media_kwd)) return Directive::Media;
+        if (is(mixin_kwd)) return Directive::Mixin;
+        break;
+      case 'r':
+        if (is(return_kwd)) return Directive::Return;
+        break;
+      case 's':
+        if (is(supports_kwd)) return Directive::Supports;
+        break;
+      case 'w':
+        if (is(warn_kwd)) return Directive::Warn;
+        if (is(while_kwd)) return Directive::While;
+        break;
+    }
+    return Directive::Other;
+  }
+
+  // check if the char can start a selector (see `re_selector_list`)
+  static bool is_selector_start(char chr)
+  {
+    unsigned char c = static_cast<unsigned char>(chr);
+    switch (c) {
+      case ';': case '<': case '?': case '@':
+      case '`': case '{': case '}': case 0x7F:
+        return false;
+      default:
+        // control chars only as white-space
+        return c >= 0x20 || Util::ascii_isspace(c);
+    }
+  }
+
   // parser for a single node in a block
   // semicolons must be lexed beforehand
   bool Parser::parse_block_node(bool is_root) {
@@ -217,19 +299,23 @@ namespace Sass {
 
     // also parse block comments
 
+    // the first char decides what we try to lex,
+    // at-rules are dispatched by their scanned name
+    Directive directive = directive_at(position);
+
     // first parse everything that is allowed in functions
-    if (lex < variable >(true)) { block->append(parse_assignment()); }
-    else if (lex < kwd_err >(true)) { block->append(parse_error()); }
-    else if (lex < kwd_dbg >(true)) { block->append(parse_debug()); }
-    else if (lex < kwd_warn >(true)) { block->append(parse_warning()); }
-    else if (lex < kwd_if_directive >(true)) { block->append(parse_if_directive()); }
-    else if (lex < kwd_for_directive >(true)) { block->append(parse_for_directive()); }
-    else if (lex < kwd_each_directive >(true)) { block->append(parse_each_directive()); }
-    else if (lex < kwd_while_directive >(true)) { block->append(parse_while_directive()); }
-    else if (lex < kwd_return_directive >(true)) { block->append(parse_return_directive()); }
+    if (*position == '$' && lex < variable >(true)) { block->append(parse_assignment()); }
+    else if (directive == Directive::Error && lex < kwd_err >(true)) { block->append(parse_error()); }
+    else if (directive == Directive::Debug && lex < kwd_dbg >(true)) { block->append(parse_debug()); }
+    else if (directive == Directive::Warn && lex < kwd_warn >(true)) { block->append(parse_warning()); }
+    else if (directive == Directive::If && lex < kwd_if_directive >(true)) { block->append(parse_if_directive()); }
+    else if (directive == Directive::For && lex < kwd_for_directive >(true)) { block->append(parse_for_directive()); }
+    else if (directive == Directive::Each && lex < kwd_each_directive >(true)) { block->append(parse_each_directive()); }
+    else if (directive == Directive::While && lex < kwd_while_directive >(true)) { block->append(parse_while_directive()); }
+    else if (directive == Directive::Return && lex < kwd_return_directive >(true)) { block->append(parse_return_directive()); }
 
     // parse imports to process later
-    else if (lex < kwd_import >(true)) {
+    else if (directive == Directive::Import && lex < kwd_import >(true)) {
       Scope parent = stack.empty() ? Scope::Rules : stack.back();
       if (parent != Scope::Function && parent != Scope::Root && parent != Scope::Rules && parent != Scope::Media) {
         if (! peek_css< uri_prefix >(position)) { // this seems to go in ruby sass 3.4.20
@@ -247,7 +333,7 @@ namespace Sass {
       }
     }
 
-    else if (lex < kwd_extend >(true)) {
+    else if (directive == Directive::Extend && lex < kwd_extend >(true)) {
       Lookahead lookahead = lookahead_for_include(position);
       if (!lookahead.found) css_error("Invalid CSS", " after ", ": expected selector, was ");
       SelectorListObj target;
@@ -271,6 +357,7 @@ namespace Sass {
 
     // selector may contain interpolations which need delayed evaluation
     else if (
+      is_selector_start(*position) &&
       !(lookahead_result = lookahead_for_selector(position)).error &&
       !lookahead_result.is_custom_property
     )
@@ -279,21 +366,21 @@ namespace Sass {
     }
 
     // parse multiple specific keyword directives
-    else if (lex < kwd_media >(true)) { block->append(parseMediaRule()); }
-    else if (lex < kwd_at_root >(true)) { block->append(parse_at_root_block()); }
-    else if (lex < kwd_include_directive >(true)) { block->append(parse_include_directive()); }
-    else if (lex < kwd_content_directive >(true)) { block->append(parse_content_directive()); }
-    else if (lex < kwd_supports_directive >(true)) { block->append(parse_supports_directive()); }
-    else if (lex < kwd_mixin >(true)) { block->append(parse_definition(Definition::MIXIN)); }
-    else if (lex < kwd_function >(true)) { block->append(parse_definition(Definition::FUNCTION)); }
+    else if (directive == Directive::Media && lex < kwd_media >(true)) { block->append(parseMediaRule()); }
+    else if (directive == Directive::AtRoot && lex < kwd_at_root >(true)) { block->append(parse_at_root_block()); }
+    else if (directive == Directive::Include && lex < kwd_include_directive >(true)) { block->append(parse_include_directive()); }
+    else if (directive == Directive::Content && lex < kwd_content_directive >(true)) { block->append(parse_content_directive()); }
+    else if (directive == Directive::Supports && lex < kwd_supports_directive >(true)) { block->append(parse_supports_directive()); }
+    else if (directive == Directive::Mixin && lex < kwd_mixin >(true)) { block->append(parse_definition(Definition::MIXIN)); }
+    else if (directive == Directive::Function && lex < kwd_function >(true)) { block->append(parse_definition(Definition::FUNCTION)); }
 
     // ignore the @charset directive for now
-    else if (lex< kwd_charset_directive >(true)) { parse_charset_directive(); }
+    else if (directive == Directive::Charset && lex< kwd_charset_directive >(true)) { parse_charset_directive(); }
 
-    else if (lex < exactly < else_kwd >>(true)) { error("Invalid CSS: @else must come after @if"); }
+    else if (directive == Directive::Else && lex < exactly < else_kwd >>(true)) { error("Invalid CSS: @else must come after @if"); }
 
     // generic at keyword (keep last)
-    else if (lex< at_keyword >(true)) { block->append(parse_directive()); }
+    else if (directive != Directive::None && lex< at_keyword >(true)) { block->append(parse_directive()); }
 
     else if (is_root && stack.back() != Scope::AtRoot /* && block->is_root() */) {
       lex< css_whitespace >();
@@ -2072,7 +2159,7 @@ namespace Sass {
       css_error("Invalid CSS", " after ", ": expected identifier, was ");
     }
     // return object
-    return token;
+    return lexed;
   }
   // helper to parse identifier
   Token Parser::lex_identifier()
@@ -2082,7 +2169,7 @@ namespace Sass {
       css_error("Invalid CSS", " after ", ": expected identifier, was ");
     }
     // return object
-    return token;
+    return lexed;
   }
 
   EachRuleObj Parser::parse_each_directive()
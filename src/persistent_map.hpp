@@ -0,0 +1,291 @@
+#ifndef SASS_PERSISTENT_MAP_H
+#define SASS_PERSISTENT_MAP_H
+
+// sass.hpp must go before all system headers to get the
+// __EXTENSIONS__ fix on Solaris.
+#include "sass.hpp"
+
+#include <memory>
+#include <cstdint>
+#include <functional>
+
+namespace Sass {
+
+  // ##########################################################################
+  // Persistent hash map that keeps the insertion order. Copies are cheap and
+  // share all data, changes only copy the path down to the changed entry
+  // (hash array mapped trie). The insertion order is kept in a log of keys,
+  // shared by all copies and appended in place by the copy at its end.
+  // Copies are meant to stay on one thread (like the AST nodes using them).
+  // ##########################################################################
+  template<
+    class Key,
+    class T,
+    class Hash = std::hash<Key>,
+    class KeyEqual = std::equal_to<Key>
+  >
+  class persistent_map {
+
+  private:
+
+    // Bits of the hash consumed on every level
+    static const size_t BITS = 5;
+    static const size_t MASK = (1 << BITS) - 1;
+    static const size_t HASH_BITS = sizeof(size_t) * 8;
+
+    struct Entry {
+      Key key;
+      T value;
+      size_t hash;
+      // Position in the order log
+      size_t order;
+    };
+
+    struct Node;
+    typedef std::shared_ptr<Node> NodePtr;
+
+    // Every slot holds either an entry or a sub-node, the bitmaps
+    // tell which slots are in use. Below the last level a node only
+    // holds entries with identical hashes (bitmaps are unused).
+    struct Node {
+      uint32_t datamap = 0;
+      uint32_t nodemap = 0;
+      sass::vector<Entry> entries;
+      sass::vector<NodePtr> nodes;
+      bool empty() const { return entries.empty() && nodes.empty(); }
+    };
+
+    struct Logged {
+      Key key;
+      size_t hash;
+    };
+
+    typedef sass::vector<Logged> Log;
+
+    NodePtr root_;
+    std::shared_ptr<Log> log_;
+    // Log entries belonging to this copy
+    size_t logged_;
+    size_t size_;
+
+    static size_t popcount(uint32_t v)
+    {
+      v = v - ((v >> 1) & 0x55555555);
+      v = (v & 0x33333333) + ((v >> 2) & 0x33333333);
+      return (((v + (v >> 4)) & 0x0F0F0F0F) * 0x01010101) >> 24;
+    }
+
+    static uint32_t bit(size_t hash, size_t shift)
+    {
+      return uint32_t(1) << ((hash >> shift) & MASK);
+    }
+
+    static size_t index(uint32_t bitmap, uint32_t bit)
+    {
+      return popcount(bitmap & (bit - 1));
+    }
+
+    static bool matches(const Entry& entry, const Key& key, size_t hash)
+    {
+      return entry.hash == hash && KeyEqual()(entry.key, key);
+    }
+
+    const Entry* lookup(const Key& key, size_t hash) const
+    {
+      const Node* node = root_.get();
+      for (size_t shift = 0; node != nullptr; shift += BITS) {
+        if (shift >= HASH_BITS) {
+          for (const Entry& entry : node->entries) {
+            if (matches(entry, key, hash)) return &entry;
+          }
+          return nullptr;
+        }
+        uint32_t b = bit(hash, shift);
+        if (node->datamap & b) {
+          const Entry& entry = node->entries[index(node->datamap, b)];
+          return matches(entry, key, hash) ? &entry : nullptr;
+        }
+        if (!(node->nodemap & b)) return nullptr;
+        node = node->nodes[index(node->nodemap, b)].get();
+      }
+      return nullptr;
+    }
+
+    // Node holding two entries with distinct keys
+    static NodePtr join(const Entry& a, const Entry& b, size_t shift)
+    {
+      NodePtr node = std::make_shared<Node>();
+      if (shift >= HASH_BITS) {
+        node->entries.push_back(a);
+        node->entries.push_back(b);
+        return node;
+      }
+      uint32_t ba = bit(a.hash, shift);
+      uint32_t bb = bit(b.hash, shift);
+      if (ba == bb) {
+        node->nodemap = ba;
+        node->nodes.push_back(join(a, b, shift + BITS));
+      }
+      else {
+        node->datamap = ba | bb;
+        node->entries.push_back(ba < bb ? a : b);
+        node->entries.push_back(ba < bb ? b : a);
+      }
+      return node;
+    }
+
+    // Returns a copy of the node with the entry inserted (or updated)
+    static NodePtr insert(const Node* node, const Entry& entry, size_t shift)
+    {
+      NodePtr copy = node ? std::make_shared<Node>(*node) : std::make_shared<Node>();
+      if (shift >= HASH_BITS) {
+        for (Entry& item : copy->entries) {
+          if (matches(item, entry.key, entry.hash)) {
+            item.value = entry.value;
+            return copy;
+          }
+        }
+        copy->entries.push_back(entry);
+        return copy;
+      }
+      uint32_t b = bit(entry.hash, shift);
+      if (copy->datamap & b) {
+        size_t i = index(copy->datamap, b);
+        if (matches(copy->entries[i], entry.key, entry.hash)) {
+          // keep the original key
+          copy->entries[i].value = entry.value;
+          return copy;
+        }
+        // move both into a new sub-node
+        NodePtr sub = join(copy->entries[i], entry, shift + BITS);
+        copy->entries.erase(copy->entries.begin() + i);
+        copy->datamap ^= b;
+        copy->nodemap |= b;
+        copy->nodes.insert(copy->nodes.begin() + index(copy->nodemap, b), sub);
+      }
+      else if (copy->nodemap & b) {
+        NodePtr& sub = copy->nodes[index(copy->nodemap, b)];
+        sub = insert(sub.get(), entry, shift + BITS);
+      }
+      else {
+        copy->datamap |= b;
+        copy->entries.insert(copy->entries.begin() + index(copy->datamap, b), entry);
+      }
+      return copy;
+    }
+
+    // Returns a copy of the node without the key (must exist)
+    static NodePtr erase(const Node* node, const Key& key, size_t hash, size_t shift)
+    {
+      NodePtr copy = std::make_shared<Node>(*node);
+      if (shift >= HASH_BITS) {
+        for (size_t i = 0; i < copy->entries.size(); ++i) {
+          if (matches(copy->entries[i], key, hash)) {
+            copy->entries.erase(copy->entries.begin() + i);
+            break;
+          }
+        }
+        return copy;
+      }
+      uint32_t b = bit(hash, shift);
+      if (copy->datamap & b) {
+        copy->entries.erase(copy->entries.begin() + index(copy->datamap, b));
+        copy->datamap ^= b;
+      }
+      else {
+        size_t i = index(copy->nodemap, b);
+        NodePtr sub = erase(copy->nodes[i].get(), key, hash, shift + BITS);
+        if (!sub->empty()) copy->nodes[i] = sub;
+        else {
+          copy->nodes.erase(copy->nodes.begin() + i);
+          copy->nodemap ^= b;
+        }
+      }
+      return copy;
+    }
+
+    void append(const Key& key, size_t hash)
+    {
+      if (!log_) {
+        log_ = std::make_shared<Log>();
+      }
+      // another copy appended to the log already
+      else if (log_->size() != logged_) {
+        log_ = std::make_shared<Log>(log_->begin(), log_->begin() + logged_);
+      }
+      log_->push_back({ key, hash });
+      ++logged_;
+    }
+
+    // Drops erased keys from the order log
+    void compact()
+    {
+      persistent_map compacted;
+      for_each([&](const Key& key, const T& value) {
+        compacted.insert(key, value);
+      });
+      *this = compacted;
+    }
+
+  public:
+
+    persistent_map()
+    : root_(), log_(), logged_(0), size_(0)
+    { }
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    bool has(const Key& key) const
+    {
+      return lookup(key, Hash()(key)) != nullptr;
+    }
+
+    // Returns null if the key is not found
+    const T* find(const Key& key) const
+    {
+      const Entry* entry = lookup(key, Hash()(key));
+      return entry ? &entry->value : nullptr;
+    }
+
+    // Returns false if the key existed (and was updated)
+    bool insert(const Key& key, const T& value)
+    {
+      size_t hash = Hash()(key);
+      const Entry* existing = lookup(key, hash);
+      size_t order = existing ? existing->order : logged_;
+      root_ = insert(root_.get(), { key, value, hash, order }, 0);
+      if (existing) return false;
+      append(key, hash);
+      ++size_;
+      return true;
+    }
+
+    // Returns false if the key was not found
+    bool erase(const Key& key)
+    {
+      size_t hash = Hash()(key);
+      if (lookup(key, hash) == nullptr) return false;
+      root_ = erase(root_.get(), key, hash, 0);
+      --size_;
+      if (logged_ > 2 * size_ + 32) compact();
+      return true;
+    }
+
+    // Calls `fn(key, value)` in insertion order
+    template <class F>
+    void for_each(F fn) const
+    {
+      for (size_t i = 0; i < logged_; ++i) {
+        const Logged& item = (*log_)[i];
+        const Entry* entry = lookup(item.key, item.hash);
+        // skip keys erased (or erased and inserted again)
+        if (entry && entry->order == i) fn(entry->key, entry->value);
+      }
+    }
+
+  };
+
+}
+
+#endif
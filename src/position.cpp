@@ -25,7 +25,8 @@ namespace Sass {
   }
 
   Offset::Offset(const size_t line, const size_t column)
-  : line(line), column(column) { }
+  : line(static_cast<uint32_t>(line)),
+    column(static_cast<uint32_t>(column)) { }
 
   // init/create instance from const char substring
   Offset Offset::init(const char* beg, const char* end)
@@ -105,26 +106,23 @@ namespace Sass {
   }
 
   Position::Position(const size_t file)
-  : Offset(0, 0), file(file) { }
+  : Offset(0, 0), file(static_cast<uint32_t>(file)) { }
 
   Position::Position(const size_t file, const Offset& offset)
-  : Offset(offset), file(file) { }
+  : Offset(offset), file(static_cast<uint32_t>(file)) { }
 
   Position::Position(const size_t line, const size_t column)
-  : Offset(line, column), file(-1) { }
+  : Offset(line, column), file(npos) { }
 
   Position::Position(const size_t file, const size_t line, const size_t column)
-  : Offset(line, column), file(file) { }
+  : Offset(line, column), file(static_cast<uint32_t>(file)) { }
 
 
   SourceSpan::SourceSpan(const char* path, const char* src, const size_t file)
-  : Position(file, 0, 0), path(path), src(src), offset(0, 0), token() { }
+  : Position(file, 0, 0), path(path), src(src), offset(0, 0) { }
 
   SourceSpan::SourceSpan(const char* path, const char* src, const Position& position, Offset offset)
-  : Position(position), path(path), src(src), offset(offset), token() { }
-
-  SourceSpan::SourceSpan(const char* path, const char* src, const Token& token, const Position& position, Offset offset)
-  : Position(position), path(path), src(src), offset(offset), token(token) { }
+  : Position(position), path(path), src(src), offset(offset) { }
 
   Position Position::add(const char* begin, const char* end)
   {
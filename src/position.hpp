@@ -3,6 +3,7 @@
 
 #include <string>
 #include <cstring>
+#include <cstdint>
 // #include <iostream>
 
 namespace Sass {
@@ -37,8 +38,13 @@ namespace Sass {
       Offset off() { return *this; }
 
     public:
-      size_t line;
-      size_t column;
+      // 32 bits are plenty and keep every node's span small
+      uint32_t line;
+      uint32_t column;
+
+    public:
+      // marks an unknown file, line or column
+      static const uint32_t npos = UINT32_MAX;
 
   };
 
@@ -64,7 +70,7 @@ namespace Sass {
       // friend std::ostream& operator<<(std::ostream& strm, const Position& pos);
 
     public:
-      size_t file;
+      uint32_t file;
 
   };
 
@@ -102,9 +108,8 @@ namespace Sass {
   class SourceSpan : public Position {
 
     public: // c-tor
-      SourceSpan(const char* path, const char* src = 0, const size_t file = sass::string::npos);
+      SourceSpan(const char* path, const char* src = 0, const size_t file = npos);
       SourceSpan(const char* path, const char* src, const Position& position, Offset offset = Offset(0, 0));
-      SourceSpan(const char* path, const char* src, const Token& token, const Position& position, Offset offset = Offset(0, 0));
 
     public: // down casts
       Offset off() { return *this; }
@@ -115,7 +120,6 @@ namespace Sass {
       const char* path;
       const char* src;
       Offset offset;
-      Token token;
 
   };
 
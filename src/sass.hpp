@@ -47,6 +47,16 @@
 # endif
 #endif
 
+// thread local storage specifier
+// MSVC 2013 does not support it yet
+#ifndef SASS_THREAD_LOCAL
+# if defined(_MSC_VER) && _MSC_VER < 1900
+#  define SASS_THREAD_LOCAL __declspec(thread)
+# else
+#  define SASS_THREAD_LOCAL thread_local
+# endif
+#endif
+
 
 // include C-API header
 #include "sass/base.h"
@@ -6,6 +6,10 @@
 #include "sass_functions.hpp"
 #include "json.hpp"
 
+#include <atomic>
+#include <thread>
+#include <system_error>
+
 #define LFEED "\n"
 
 // C++ helper
@@ -75,8 +79,8 @@ namespace Sass {
       }
 
       // now create the code trace (ToDo: maybe have util functions?)
-      if (e.pstate.line != sass::string::npos &&
-          e.pstate.column != sass::string::npos &&
+      if (e.pstate.line != Position::npos &&
+          e.pstate.column != Position::npos &&
           e.pstate.src != nullptr) {
         size_t lines = e.pstate.line;
         // scan through src until target line
@@ -421,6 +425,67 @@ extern "C" {
     return sass_compile_context(file_ctx, cpp_ctx);
   }
 
+  int ADDCALL sass_precompile_file_context(Sass_File_Context* file_ctx)
+  {
+    if (file_ctx == 0) return 1;
+    if (file_ctx->error_status)
+      return file_ctx->error_status;
+    try {
+      if (file_ctx->input_path == 0) { throw(std::runtime_error("File context has no input path")); }
+      if (*file_ctx->input_path == 0) { throw(std::runtime_error("File context has empty input path")); }
+    }
+    catch (...) { return handle_errors(file_ctx) | 1; }
+    File_Context* cpp_ctx = new File_Context(*file_ctx);
+    Sass_Compiler* compiler = sass_prepare_context(file_ctx, cpp_ctx);
+    try {
+      // allocate all nodes from the context arena
+      Memory::ArenaScope scope(cpp_ctx->arena);
+      cpp_ctx->precompile();
+    }
+    // pass errors to generic error handler
+    catch (...) { handle_errors(file_ctx); }
+    sass_delete_compiler(compiler);
+    return file_ctx->error_status;
+  }
+
+  size_t ADDCALL sass_compile_batch(struct Sass_File_Context** ctxs, size_t n, int threads)
+  {
+    if (ctxs == 0 || n == 0) return 0;
+    size_t workers = threads > 0 ? size_t(threads) : std::thread::hardware_concurrency();
+    if (workers == 0) workers = 1;
+    if (workers > n) workers = n;
+    // workers grab the next pending context until all are done,
+    // so long running compilations do not hold up the others
+    std::atomic<size_t> next(0);
+    std::atomic<size_t> failed(0);
+    auto work = [ctxs, n, &next, &failed]() {
+      for (size_t i = next++; i < n; i = next++) {
+        if (sass_compile_file_context(ctxs[i]) != 0) ++failed;
+      }
+    };
+    sass::vector<std::thread> pool;
+    pool.reserve(workers - 1);
+    for (size_t i = 1; i < workers; ++i) {
+      // just continue with fewer workers
+      try { pool.emplace_back(work); }
+      catch (std::system_error&) { break; }
+    }
+    // calling thread takes part too
+    work();
+    for (std::thread& thread : pool) thread.join();
+    return failed;
+  }
+
+  void ADDCALL sass_clear_stylesheet_cache(void)
+  {
+    StyleSheetCache::clear();
+  }
+
+  void ADDCALL sass_clear_directory_index(void)
+  {
+    File::DirectoryIndex::clear();
+  }
+
   int ADDCALL sass_compiler_parse(struct Sass_Compiler* compiler)
   {
     if (compiler == 0) return 1;
@@ -430,6 +495,8 @@ extern "C" {
     if (compiler->cpp_ctx == NULL) return 1;
     if (compiler->c_ctx->error_status)
       return compiler->c_ctx->error_status;
+    // allocate all nodes from the context arena
+    Memory::ArenaScope scope(compiler->cpp_ctx->arena);
     // parse the context we have set up (file or data)
     compiler->root = sass_parse_block(compiler);
     // success
@@ -449,6 +516,8 @@ extern "C" {
     compiler->state = SASS_COMPILER_EXECUTED;
     Context* cpp_ctx = compiler->cpp_ctx;
     Block_Obj root = compiler->root;
+    // allocate all nodes from the context arena
+    Memory::ArenaScope scope(cpp_ctx->arena);
     // compile the parsed root block
     try { compiler->c_ctx->output_string = cpp_ctx->render(root); }
     // pass catched errors to generic error handler
@@ -470,6 +539,7 @@ extern "C" {
     options->include_path = 0;
     options->source_map_file = 0;
     options->source_map_root = 0;
+    options->stylesheet_cache_path = 0;
     options->c_functions = 0;
     options->c_importers = 0;
     options->c_headers = 0;
@@ -516,6 +586,7 @@ extern "C" {
     free(options->include_path);
     free(options->source_map_file);
     free(options->source_map_root);
+    free(options->stylesheet_cache_path);
     // Reset our pointers
     options->input_path = 0;
     options->output_path = 0;
@@ -523,6 +594,7 @@ extern "C" {
     options->include_path = 0;
     options->source_map_file = 0;
     options->source_map_root = 0;
+    options->stylesheet_cache_path = 0;
     options->c_functions = 0;
     options->c_importers = 0;
     options->c_headers = 0;
@@ -632,9 +704,15 @@ extern "C" {
   IMPLEMENT_SASS_OPTION_ACCESSOR(bool, source_map_file_urls);
   IMPLEMENT_SASS_OPTION_ACCESSOR(bool, omit_source_map_url);
   IMPLEMENT_SASS_OPTION_ACCESSOR(bool, is_indented_syntax_src);
+  IMPLEMENT_SASS_OPTION_ACCESSOR(bool, stylesheet_cache);
+  IMPLEMENT_SASS_OPTION_ACCESSOR(bool, load_precompiled);
+  IMPLEMENT_SASS_OPTION_ACCESSOR(bool, map_files);
+  IMPLEMENT_SASS_OPTION_ACCESSOR(enum Sass_Directory_Index, directory_index);
   IMPLEMENT_SASS_OPTION_ACCESSOR(Sass_Function_List, c_functions);
   IMPLEMENT_SASS_OPTION_ACCESSOR(Sass_Importer_List, c_importers);
   IMPLEMENT_SASS_OPTION_ACCESSOR(Sass_Importer_List, c_headers);
+  IMPLEMENT_SASS_OPTION_ACCESSOR(Sass_Output_Writer, output_writer);
+  IMPLEMENT_SASS_OPTION_ACCESSOR(void*, output_writer_cookie);
   IMPLEMENT_SASS_OPTION_ACCESSOR(const char*, indent);
   IMPLEMENT_SASS_OPTION_ACCESSOR(const char*, linefeed);
   IMPLEMENT_SASS_OPTION_STRING_SETTER(const char*, plugin_path, 0);
@@ -643,6 +721,7 @@ extern "C" {
   IMPLEMENT_SASS_OPTION_STRING_ACCESSOR(const char*, output_path, 0);
   IMPLEMENT_SASS_OPTION_STRING_ACCESSOR(const char*, source_map_file, 0);
   IMPLEMENT_SASS_OPTION_STRING_ACCESSOR(const char*, source_map_root, 0);
+  IMPLEMENT_SASS_OPTION_STRING_ACCESSOR(const char*, stylesheet_cache_path, 0);
 
   // Create getter and setters for context
   IMPLEMENT_SASS_CONTEXT_GETTER(int, error_status);
@@ -23,6 +23,18 @@ struct Sass_Options : Sass_Output_Options {
   // Treat source_string as sass (as opposed to scss)
   bool is_indented_syntax_src;
 
+  // Reuse parsed stylesheets between compilations
+  bool stylesheet_cache;
+
+  // Load trees stored by sass_precompile_file_context
+  bool load_precompiled;
+
+  // Map big stylesheets into memory instead of reading them
+  bool map_files;
+
+  // Resolve imports from cached directory listings
+  enum Sass_Directory_Index directory_index;
+
   // The input path is used for source map
   // generation. It can be used to define
   // something with string compilation or to
@@ -56,6 +68,9 @@ struct Sass_Options : Sass_Output_Options {
   // Directly inserted in source maps
   char* source_map_root;
 
+  // Directory to store cached stylesheets
+  char* stylesheet_cache_path;
+
   // Custom functions that can be called from sccs code
   Sass_Function_List c_functions;
 
@@ -65,6 +80,13 @@ struct Sass_Options : Sass_Output_Options {
   // List of custom headers
   Sass_Importer_List c_headers;
 
+  // Pass the css to this callback in chunks while it
+  // is rendered, instead of storing it as the output
+  // string (stays null); the preamble is passed last,
+  // but goes before the body (see Sass_Output_Part)
+  Sass_Output_Writer output_writer;
+  void* output_writer_cookie;
+
 };
 
 
@@ -75,7 +97,8 @@ struct Sass_Context : Sass_Options
   // store context type info
   enum Sass_Input_Style type;
 
-  // generated output data
+  // generated output data (null if the
+  // css was passed to the output writer)
   char* output_string;
 
   // generated source map json
@@ -0,0 +1,1685 @@
+// sass.hpp must go before all system headers to get the
+// __EXTENSIONS__ fix on Solaris.
+#include "sass.hpp"
+
+#include "serializer.hpp"
+#include "context.hpp"
+#include "error_handling.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+
+namespace Sass {
+
+  namespace {
+
+    // bump on any change to the encoding below
+    const size_t FORMAT_VERSION = 4;
+
+    // deeper than the parser creates, but well within the stack
+    const size_t MAX_DEPTH = 2048;
+
+    const char MAGIC[] = { 'S', 'A', 'S', 'S', 'C' };
+
+    // Node tags, never reorder (only append)
+    enum Tag {
+      NO_NODE,
+      // statements
+      BLOCK,
+      STYLE_RULE,
+      BUBBLE,
+      TRACE,
+      SUPPORTS_RULE,
+      MEDIA_RULE,
+      CSS_MEDIA_RULE,
+      CSS_MEDIA_QUERY,
+      AT_ROOT_RULE,
+      AT_RULE,
+      KEYFRAME_RULE,
+      DECLARATION,
+      ASSIGNMENT,
+      IMPORT,
+      IMPORT_STUB,
+      WARNING_RULE,
+      ERROR_RULE,
+      DEBUG_RULE,
+      COMMENT,
+      IF,
+      FOR_RULE,
+      EACH_RULE,
+      WHILE_RULE,
+      RETURN,
+      CONTENT,
+      EXTEND_RULE,
+      DEFINITION,
+      MIXIN_CALL,
+      // expressions
+      NULL_VALUE,
+      LIST,
+      MAP,
+      FUNCTION,
+      BINARY_EXPRESSION,
+      UNARY_EXPRESSION,
+      FUNCTION_CALL,
+      CUSTOM_WARNING,
+      CUSTOM_ERROR,
+      VARIABLE,
+      NUMBER,
+      COLOR_RGBA,
+      COLOR_HSLA,
+      BOOLEAN,
+      STRING_SCHEMA,
+      STRING_CONSTANT,
+      STRING_QUOTED,
+      SUPPORTS_OPERATION,
+      SUPPORTS_NEGATION,
+      SUPPORTS_DECLARATION,
+      SUPPORTS_INTERPOLATION,
+      MEDIA_QUERY,
+      MEDIA_QUERY_EXPRESSION,
+      AT_ROOT_QUERY,
+      PARENT_REFERENCE,
+      // parameters and arguments
+      PARAMETER,
+      PARAMETERS,
+      ARGUMENT,
+      ARGUMENTS,
+      // selectors
+      SELECTOR_SCHEMA,
+      PLACEHOLDER_SELECTOR,
+      TYPE_SELECTOR,
+      CLASS_SELECTOR,
+      ID_SELECTOR,
+      ATTRIBUTE_SELECTOR,
+      PSEUDO_SELECTOR,
+      SELECTOR_COMBINATOR,
+      COMPOUND_SELECTOR,
+      COMPLEX_SELECTOR,
+      SELECTOR_LIST
+    };
+
+    // FNV-1a, only used to detect changed sources and damaged data
+    uint64_t hash_source(const char* source, size_t length)
+    {
+      uint64_t hash = 14695981039346656037ULL;
+      for (size_t i = 0; i < length; ++i) {
+        hash ^= static_cast<unsigned char>(source[i]);
+        hash *= 1099511628211ULL;
+      }
+      return hash;
+    }
+
+    // ends the data of every node
+    char check_byte(const char* data, size_t length)
+    {
+      return static_cast<char>(hash_source(data, length) & 0xff);
+    }
+
+    // always stored little endian
+    void write_fixed(sass::string& buffer, uint64_t value)
+    {
+      for (size_t i = 0; i < 8; ++i) {
+        buffer.push_back(static_cast<char>(value >> (i * 8)));
+      }
+    }
+
+  }
+
+  /////////////////////////////////////////////////////////////////////////
+  /////////////////////////////////////////////////////////////////////////
+
+  Serializer::Serializer(const char* source)
+  : buffer()
+  {
+    size_t length = source ? std::strlen(source) : 0;
+    buffer.append(MAGIC, sizeof(MAGIC));
+    write_size(FORMAT_VERSION);
+    write_size(length);
+    write_fixed(buffer, hash_source(source, length));
+  }
+
+  sass::string Serializer::data() const
+  {
+    sass::string sealed(buffer);
+    write_fixed(sealed, hash_source(buffer.data(), buffer.size()));
+    return sealed;
+  }
+
+  // variable length, 7 bits per byte
+  void Serializer::write_size(size_t value)
+  {
+    uint64_t rest = value;
+    while (rest >= 0x80) {
+      buffer.push_back(static_cast<char>((rest & 0x7f) | 0x80));
+      rest >>= 7;
+    }
+    buffer.push_back(static_cast<char>(rest));
+  }
+
+  void Serializer::write_bool(bool value)
+  {
+    buffer.push_back(value ? 1 : 0);
+  }
+
+  void Serializer::write_double(double value)
+  {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    write_fixed(buffer, bits);
+  }
+
+  void Serializer::write_string(const sass::string& value)
+  {
+    write_size(value.size());
+    buffer.append(value);
+  }
+
+  void Serializer::write_strings(const sass::vector<sass::string>& values)
+  {
+    write_size(values.size());
+    for (const sass::string& value : values) write_string(value);
+  }
+
+  // units are stored by name
+  void Serializer::write_units(const UnitList& units)
+  {
+    write_size(units.size());
+    for (const Unit& unit : units) write_string(unit.name());
+  }
+
+  // path, source and file index are given when loading
+  void Serializer::write_span(const SourceSpan& pstate)
+  {
+    write_size(pstate.line);
+    write_size(pstate.column);
+    write_size(pstate.offset.line);
+    write_size(pstate.offset.column);
+  }
+
+  // resolved again when loading
+  void Serializer::write_include(const Include& include)
+  {
+    write_string(include.load_path);
+  }
+
+  void Serializer::write_node(size_t tag, AST_Node* node)
+  {
+    write_size(tag);
+    write_span(node->pstate());
+  }
+
+  // flags are packed with the type
+  void Serializer::write_statement(Statement* node)
+  {
+    write_size(node->statement_type() << 1 | node->group_end());
+    write_size(node->tabs());
+  }
+
+  void Serializer::write_expression(Expression* node)
+  {
+    write_size(node->concrete_type() << 3
+      | node->is_delayed() << 2
+      | node->is_expanded() << 1
+      | node->is_interpolant());
+  }
+
+  void Serializer::write_simple(SimpleSelector* node)
+  {
+    write_expression(node);
+    write_string(node->ns());
+    write_string(node->name());
+    write_bool(node->has_ns());
+  }
+
+  // a check byte over the data of the node (children included)
+  // follows its fields, so damage is caught close to where it is
+  void Serializer::write(AST_Node* node)
+  {
+    if (node == nullptr) write_size(NO_NODE);
+    else {
+      size_t start = buffer.size();
+      node->perform(this);
+      buffer.push_back(check_byte(buffer.data() + start, buffer.size() - start));
+    }
+  }
+
+  /////////////////////////////////////////////////////////////////////////
+  /////////////////////////////////////////////////////////////////////////
+
+  void Serializer::operator()(Block* x)
+  {
+    write_node(BLOCK, x);
+    write_statement(x);
+    write_bool(x->is_root());
+    write_elements(*x);
+  }
+
+  void Serializer::operator()(StyleRule* x)
+  {
+    write_node(STYLE_RULE, x);
+    write_statement(x);
+    write(x->block());
+    write(x->selector());
+    write(x->schema());
+    write_bool(x->is_root());
+  }
+
+  void Serializer::operator()(Bubble* x)
+  {
+    write_node(BUBBLE, x);
+    write_statement(x);
+    write(x->node());
+    write_bool(x->group_end());
+  }
+
+  void Serializer::operator()(Trace* x)
+  {
+    write_node(TRACE, x);
+    write_statement(x);
+    write(x->block());
+    write_size(static_cast<unsigned char>(x->type()));
+    write_string(x->name());
+  }
+
+  void Serializer::operator()(SupportsRule* x)
+  {
+    write_node(SUPPORTS_RULE, x);
+    write_statement(x);
+    write(x->block());
+    write(x->condition());
+  }
+
+  void Serializer::operator()(MediaRule* x)
+  {
+    write_node(MEDIA_RULE, x);
+    write_statement(x);
+    write(x->block());
+    write(x->schema());
+  }
+
+  void Serializer::operator()(CssMediaRule* x)
+  {
+    write_node(CSS_MEDIA_RULE, x);
+    write_statement(x);
+    write(x->block());
+    write_elements(*x);
+  }
+
+  void Serializer::operator()(CssMediaQuery* x)
+  {
+    write_node(CSS_MEDIA_QUERY, x);
+    write_string(x->modifier());
+    write_string(x->type());
+    write_strings(x->features());
+  }
+
+  void Serializer::operator()(AtRootRule* x)
+  {
+    write_node(AT_ROOT_RULE, x);
+    write_statement(x);
+    write(x->block());
+    write(x->expression());
+  }
+
+  void Serializer::operator()(AtRule* x)
+  {
+    write_node(AT_RULE, x);
+    write_statement(x);
+    write(x->block());
+    write_string(x->keyword());
+    write(x->selector());
+    write(x->value());
+  }
+
+  void Serializer::operator()(Keyframe_Rule* x)
+  {
+    write_node(KEYFRAME_RULE, x);
+    write_statement(x);
+    write(x->block());
+    write(x->name());
+  }
+
+  void Serializer::operator()(Declaration* x)
+  {
+    write_node(DECLARATION, x);
+    write_statement(x);
+    write(x->block());
+    write(x->property());
+    write(x->value());
+    write_bool(x->is_important());
+    write_bool(x->is_custom_property());
+    write_bool(x->is_indented());
+  }
+
+  void Serializer::operator()(Assignment* x)
+  {
+    write_node(ASSIGNMENT, x);
+    write_statement(x);
+    write_string(x->variable());
+    write(x->value());
+    write_bool(x->is_default());
+    write_bool(x->is_global());
+  }
+
+  void Serializer::operator()(Import* x)
+  {
+    write_node(IMPORT, x);
+    write_statement(x);
+    write_size(x->urls().size());
+    for (ExpressionObj& url : x->urls()) write(url);
+    write_size(x->incs().size());
+    for (Include& inc : x->incs()) write_include(inc);
+    write(x->import_queries());
+  }
+
+  void Serializer::operator()(Import_Stub* x)
+  {
+    write_node(IMPORT_STUB, x);
+    write_include(x->resource());
+    write_statement(x);
+  }
+
+  void Serializer::operator()(WarningRule* x)
+  {
+    write_node(WARNING_RULE, x);
+    write_statement(x);
+    write(x->message());
+  }
+
+  void Serializer::operator()(ErrorRule* x)
+  {
+    write_node(ERROR_RULE, x);
+    write_statement(x);
+    write(x->message());
+  }
+
+  void Serializer::operator()(DebugRule* x)
+  {
+    write_node(DEBUG_RULE, x);
+    write_statement(x);
+    write(x->value());
+  }
+
+  void Serializer::operator()(Comment* x)
+  {
+    write_node(COMMENT, x);
+    write_statement(x);
+    write(x->text());
+    write_bool(x->is_important());
+  }
+
+  void Serializer::operator()(If* x)
+  {
+    write_node(IF, x);
+    write_statement(x);
+    write(x->block());
+    write(x->predicate());
+    write(x->alternative());
+  }
+
+  void Serializer::operator()(ForRule* x)
+  {
+    write_node(FOR_RULE, x);
+    write_statement(x);
+    write(x->block());
+    write_string(x->variable());
+    write(x->lower_bound());
+    write(x->upper_bound());
+    write_bool(x->is_inclusive());
+  }
+
+  void Serializer::operator()(EachRule* x)
+  {
+    write_node(EACH_RULE, x);
+    write_statement(x);
+    write(x->block());
+    write_strings(x->variables());
+    write(x->list());
+  }
+
+  void Serializer::operator()(WhileRule* x)
+  {
+    write_node(WHILE_RULE, x);
+    write_statement(x);
+    write(x->block());
+    write(x->predicate());
+  }
+
+  void Serializer::operator()(Return* x)
+  {
+    write_node(RETURN, x);
+    write_statement(x);
+    write(x->value());
+  }
+
+  void Serializer::operator()(Content* x)
+  {
+    write_node(CONTENT, x);
+    write_statement(x);
+    write(x->arguments());
+  }
+
+  void Serializer::operator()(ExtendRule* x)
+  {
+    write_node(EXTEND_RULE, x);
+    write_statement(x);
+    write_bool(x->isOptional());
+    write(x->selector());
+    write(x->schema());
+  }
+
+  void Serializer::operator()(Definition* x)
+  {
+    // built-in and custom functions live in the environment
+    if (x->native_function() || x->c_function()) {
+      throw SerializationError("Unable to serialize native function " + x->name());
+    }
+    write_node(DEFINITION, x);
+    write_statement(x);
+    write(x->block());
+    write_string(x->name());
+    write(x->parameters());
+    write_size(x->type());
+  }
+
+  void Serializer::operator()(Mixin_Call* x)
+  {
+    write_node(MIXIN_CALL, x);
+    write_statement(x);
+    write(x->block());
+    write_string(x->name());
+    write(x->arguments());
+    write(x->block_parameters());
+  }
+
+  /////////////////////////////////////////////////////////////////////////
+  /////////////////////////////////////////////////////////////////////////
+
+  void Serializer::operator()(Null* x)
+  {
+    write_node(NULL_VALUE, x);
+    write_expression(x);
+  }
+
+  void Serializer::operator()(List* x)
+  {
+    write_node(LIST, x);
+    write_expression(x);
+    write_size(x->separator());
+    write_bool(x->is_arglist());
+    write_bool(x->is_bracketed());
+    write_bool(x->from_selector());
+    write_elements(*x);
+  }
+
+  void Serializer::operator()(Map* x)
+  {
+    write_node(MAP, x);
+    write_expression(x);
+    write_size(x->length());
+    for (size_t i = 0, L = x->length(); i < L; ++i) {
+      write(x->keys()[i]);
+      write(x->values()[i]);
+    }
+    // reported when the map is evaluated
+    if (x->has_duplicate_key()) {
+      ExpressionObj key = x->get_duplicate_key();
+      write(key);
+      write(x->at(key));
+    }
+    else write(nullptr);
+  }
+
+  void Serializer::operator()(Function* x)
+  {
+    write_node(FUNCTION, x);
+    write_expression(x);
+    write(x->definition());
+    write_bool(x->is_css());
+  }
+
+  void Serializer::operator()(Binary_Expression* x)
+  {
+    write_node(BINARY_EXPRESSION, x);
+    write_expression(x);
+    write_size(x->op().operand);
+    write_bool(x->op().ws_before);
+    write_bool(x->op().ws_after);
+    write(x->left());
+    write(x->right());
+  }
+
+  void Serializer::operator()(Unary_Expression* x)
+  {
+    write_node(UNARY_EXPRESSION, x);
+    write_expression(x);
+    write_size(x->optype());
+    write(x->operand());
+  }
+
+  void Serializer::operator()(Function_Call* x)
+  {
+    // only set once the call has been resolved
+    if (x->func() || x->cookie()) {
+      throw SerializationError("Unable to serialize resolved function call " + x->name());
+    }
+    write_node(FUNCTION_CALL, x);
+    write_expression(x);
+    write(x->sname());
+    write(x->arguments());
+    write_bool(x->via_call());
+  }
+
+  void Serializer::operator()(Custom_Warning* x)
+  {
+    write_node(CUSTOM_WARNING, x);
+    write_expression(x);
+    write_string(x->message());
+  }
+
+  void Serializer::operator()(Custom_Error* x)
+  {
+    write_node(CUSTOM_ERROR, x);
+    write_expression(x);
+    write_string(x->message());
+  }
+
+  void Serializer::operator()(Variable* x)
+  {
+    write_node(VARIABLE, x);
+    write_expression(x);
+    write_string(x->name());
+  }
+
+  void Serializer::operator()(Number* x)
+  {
+    write_node(NUMBER, x);
+    write_expression(x);
+    write_double(x->value());
+    write_bool(x->zero());
+    write_units(x->numerators);
+    write_units(x->denominators);
+  }
+
+  void Serializer::operator()(Color_RGBA* x)
+  {
+    write_node(COLOR_RGBA, x);
+    write_expression(x);
+    write_string(x->disp());
+    write_double(x->a());
+    write_double(x->r());
+    write_double(x->g());
+    write_double(x->b());
+  }
+
+  void Serializer::operator()(Color_HSLA* x)
+  {
+    write_node(COLOR_HSLA, x);
+    write_expression(x);
+    write_string(x->disp());
+    write_double(x->a());
+    write_double(x->h());
+    write_double(x->s());
+    write_double(x->l());
+  }
+
+  void Serializer::operator()(Boolean* x)
+  {
+    write_node(BOOLEAN, x);
+    write_expression(x);
+    write_bool(x->value());
+  }
+
+  void Serializer::operator()(String_Schema* x)
+  {
+    write_node(STRING_SCHEMA, x);
+    write_expression(x);
+    write_bool(x->css());
+    write_elements(*x);
+  }
+
+  void Serializer::operator()(String_Constant* x)
+  {
+    write_node(STRING_CONSTANT, x);
+    write_expression(x);
+    write_size(static_cast<unsigned char>(x->quote_mark()));
+    write_string(x->value());
+  }
+
+  void Serializer::operator()(String_Quoted* x)
+  {
+    write_node(STRING_QUOTED, x);
+    write_expression(x);
+    write_size(static_cast<unsigned char>(x->quote_mark()));
+    write_string(x->value());
+  }
+
+  void Serializer::operator()(SupportsOperation* x)
+  {
+    write_node(SUPPORTS_OPERATION, x);
+    write_expression(x);
+    write(x->left());
+    write(x->right());
+    write_size(x->operand());
+  }
+
+  void Serializer::operator()(SupportsNegation* x)
+  {
+    write_node(SUPPORTS_NEGATION, x);
+    write_expression(x);
+    write(x->condition());
+  }
+
+  void Serializer::operator()(SupportsDeclaration* x)
+  {
+    write_node(SUPPORTS_DECLARATION, x);
+    write_expression(x);
+    write(x->feature());
+    write(x->value());
+  }
+
+  void Serializer::operator()(Supports_Interpolation* x)
+  {
+    write_node(SUPPORTS_INTERPOLATION, x);
+    write_expression(x);
+    write(x->value());
+  }
+
+  void Serializer::operator()(Media_Query* x)
+  {
+    write_node(MEDIA_QUERY, x);
+    write_expression(x);
+    write(x->media_type());
+    write_bool(x->is_negated());
+    write_bool(x->is_restricted());
+    write_elements(*x);
+  }
+
+  void Serializer::operator()(Media_Query_Expression* x)
+  {
+    write_node(MEDIA_QUERY_EXPRESSION, x);
+    write_expression(x);
+    write(x->feature());
+    write(x->value());
+    write_bool(x->is_interpolated());
+  }
+
+  void Serializer::operator()(At_Root_Query* x)
+  {
+    write_node(AT_ROOT_QUERY, x);
+    write_expression(x);
+    write(x->feature());
+    write(x->value());
+  }
+
+  void Serializer::operator()(Parent_Reference* x)
+  {
+    write_node(PARENT_REFERENCE, x);
+    write_expression(x);
+  }
+
+  /////////////////////////////////////////////////////////////////////////
+  /////////////////////////////////////////////////////////////////////////
+
+  void Serializer::operator()(Parameter* x)
+  {
+    write_node(PARAMETER, x);
+    write_string(x->name());
+    write(x->default_value());
+    write_bool(x->is_rest_parameter());
+  }
+
+  void Serializer::operator()(Parameters* x)
+  {
+    write_node(PARAMETERS, x);
+    write_bool(x->has_optional_parameters());
+    write_bool(x->has_rest_parameter());
+    write_elements(*x);
+  }
+
+  void Serializer::operator()(Argument* x)
+  {
+    write_node(ARGUMENT, x);
+    write_expression(x);
+    write(x->value());
+    write_string(x->name());
+    write_bool(x->is_rest_argument());
+    write_bool(x->is_keyword_argument());
+  }
+
+  void Serializer::operator()(Arguments* x)
+  {
+    write_node(ARGUMENTS, x);
+    write_expression(x);
+    write_bool(x->has_named_arguments());
+    write_bool(x->has_rest_argument());
+    write_bool(x->has_keyword_argument());
+    write_elements(*x);
+  }
+
+  /////////////////////////////////////////////////////////////////////////
+  /////////////////////////////////////////////////////////////////////////
+
+  void Serializer::operator()(Selector_Schema* x)
+  {
+    write_node(SELECTOR_SCHEMA, x);
+    write(x->contents());
+    write_bool(x->connect_parent());
+  }
+
+  void Serializer::operator()(PlaceholderSelector* x)
+  {
+    write_node(PLACEHOLDER_SELECTOR, x);
+    write_simple(x);
+  }
+
+  void Serializer::operator()(TypeSelector* x)
+  {
+    write_node(TYPE_SELECTOR, x);
+    write_simple(x);
+  }
+
+  void Serializer::operator()(ClassSelector* x)
+  {
+    write_node(CLASS_SELECTOR, x);
+    write_simple(x);
+  }
+
+  void Serializer::operator()(IDSelector* x)
+  {
+    write_node(ID_SELECTOR, x);
+    write_simple(x);
+  }
+
+  void Serializer::operator()(AttributeSelector* x)
+  {
+    write_node(ATTRIBUTE_SELECTOR, x);
+    write_simple(x);
+    write_string(x->matcher());
+    write(x->value());
+    write_size(static_cast<unsigned char>(x->modifier()));
+  }
+
+  void Serializer::operator()(PseudoSelector* x)
+  {
+    write_node(PSEUDO_SELECTOR, x);
+    write_simple(x);
+    write_string(x->normalized());
+    write(x->argument());
+    write(x->selector());
+    write_bool(x->isSyntacticClass());
+    write_bool(x->isClass());
+  }
+
+  void Serializer::operator()(SelectorCombinator* x)
+  {
+    write_node(SELECTOR_COMBINATOR, x);
+    write_expression(x);
+    write_bool(x->hasPostLineBreak());
+    write_size(x->combinator());
+  }
+
+  void Serializer::operator()(CompoundSelector* x)
+  {
+    write_node(COMPOUND_SELECTOR, x);
+    write_expression(x);
+    write_bool(x->hasPostLineBreak());
+    write_bool(x->hasRealParent());
+    write_bool(x->extended());
+    write_elements(*x);
+  }
+
+  void Serializer::operator()(ComplexSelector* x)
+  {
+    write_node(COMPLEX_SELECTOR, x);
+    write_expression(x);
+    write_bool(x->chroots());
+    write_bool(x->hasPreLineFeed());
+    write_elements(*x);
+  }
+
+  void Serializer::operator()(SelectorList* x)
+  {
+    write_node(SELECTOR_LIST, x);
+    write_expression(x);
+    write_bool(x->is_optional());
+    write_elements(*x);
+  }
+
+  /////////////////////////////////////////////////////////////////////////
+  /////////////////////////////////////////////////////////////////////////
+
+  Deserializer::Deserializer(Context& ctx, const sass::string& data, const SourceSpan& pstate)
+  : ctx(ctx),
+    pos(data.data()),
+    end(data.data() + data.size()),
+    pstate(pstate),
+    length(pstate.src ? std::strlen(pstate.src) : 0),
+    widths(),
+    includes(),
+    depth(0)
+  {
+    // width of every line of the source
+    size_t start = 0;
+    for (size_t i = 0; i < length; ++i) {
+      if (pstate.src[i] != '\n') continue;
+      widths.push_back(i - start);
+      start = i + 1;
+    }
+    widths.push_back(length - start);
+  }
+
+  size_t Deserializer::read_size()
+  {
+    uint64_t value = 0;
+    for (size_t shift = 0; shift < 64; shift += 7) {
+      if (pos == end) throw SerializationError("Unexpected end of data");
+      unsigned char byte = static_cast<unsigned char>(*pos++);
+      value |= uint64_t(byte & 0x7f) << shift;
+      if (!(byte & 0x80)) return static_cast<size_t>(value);
+    }
+    throw SerializationError("Invalid size");
+  }
+
+  bool Deserializer::read_bool()
+  {
+    if (pos == end) throw SerializationError("Unexpected end of data");
+    char value = *pos++;
+    if (value != 0 && value != 1) throw SerializationError("Invalid bool");
+    return value == 1;
+  }
+
+  double Deserializer::read_double()
+  {
+    if (end - pos < 8) throw SerializationError("Unexpected end of data");
+    uint64_t bits = 0;
+    for (size_t i = 0; i < 8; ++i) {
+      bits |= uint64_t(static_cast<unsigned char>(*pos++)) << (i * 8);
+    }
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+  }
+
+  sass::string Deserializer::read_string()
+  {
+    size_t size = read_size();
+    if (size_t(end - pos) < size) throw SerializationError("Unexpected end of data");
+    sass::string value(pos, size);
+    pos += size;
+    return value;
+  }
+
+  sass::vector<sass::string> Deserializer::read_strings()
+  {
+    sass::vector<sass::string> values;
+    for (size_t i = 0, S = read_size(); i < S; ++i) {
+      values.push_back(read_string());
+    }
+    return values;
+  }
+
+  UnitList Deserializer::read_units()
+  {
+    UnitList units;
+    for (size_t i = 0, S = read_size(); i < S; ++i) {
+      units.push_back(Unit(read_string()));
+    }
+    return units;
+  }
+
+  // spans must stay within the source (the column
+  // of the offset may wrap around for spans ending
+  // before they start, as computed by the parser)
+  SourceSpan Deserializer::read_span()
+  {
+    size_t line = read_size();
+    size_t column = read_size();
+    size_t offset_line = read_size();
+    size_t offset_column = read_size();
+    if (line >= widths.size() || column > widths[line] ||
+        line + offset_line >= widths.size() || offset_column > Offset::npos) {
+      throw SerializationError("Invalid span");
+    }
+    return SourceSpan(pstate.path, pstate.src,
+      Position(pstate.file, line, column),
+      Offset(offset_line, offset_column));
+  }
+
+  // resolve the import again (as the parser would)
+  Include Deserializer::read_include(const SourceSpan& span)
+  {
+    sass::string load_path(read_string());
+    auto it = includes.find(load_path);
+    if (it != includes.end()) return it->second;
+    Include include(ctx.load_import(Importer(load_path, pstate.path), span));
+    // the parser reports it (the path may be damaged as well)
+    if (include.abs_path.empty()) throw SerializationError("Import not found");
+    includes.insert(std::make_pair(load_path, include));
+    return include;
+  }
+
+  void Deserializer::read_statement(Statement* node)
+  {
+    size_t packed = read_size();
+    if ((packed >> 1) > Statement::IF) throw SerializationError("Invalid statement type");
+    node->statement_type(static_cast<Statement::Type>(packed >> 1));
+    node->group_end(packed & 1);
+    node->tabs(read_size());
+  }
+
+  void Deserializer::read_expression(Expression* node)
+  {
+    size_t packed = read_size();
+    if ((packed >> 3) > Expression::PARENT) throw SerializationError("Invalid expression type");
+    node->concrete_type(static_cast<Expression::Type>(packed >> 3));
+    node->is_delayed(packed & 4);
+    node->is_expanded(packed & 2);
+    node->is_interpolant(packed & 1);
+  }
+
+  void Deserializer::read_simple(SimpleSelector* node)
+  {
+    read_expression(node);
+    node->ns(read_string());
+    node->name(read_string());
+    node->has_ns(read_bool());
+  }
+
+  Block_Obj Deserializer::read_root()
+  {
+    // check that the data is complete and undamaged
+    if (end - pos < 8) return {};
+    end -= 8;
+    uint64_t checksum = 0;
+    for (size_t i = 0; i < 8; ++i) {
+      checksum |= uint64_t(static_cast<unsigned char>(end[i])) << (i * 8);
+    }
+    if (checksum != hash_source(pos, end - pos)) return {};
+    // check that the data belongs to our source
+    if (size_t(end - pos) < sizeof(MAGIC)) return {};
+    if (std::memcmp(pos, MAGIC, sizeof(MAGIC)) != 0) return {};
+    pos += sizeof(MAGIC);
+    if (read_size() != FORMAT_VERSION) return {};
+    if (read_size() != length) return {};
+    uint64_t hash = 0;
+    if (end - pos < 8) return {};
+    for (size_t i = 0; i < 8; ++i) {
+      hash |= uint64_t(static_cast<unsigned char>(*pos++)) << (i * 8);
+    }
+    if (hash != hash_source(pstate.src, length)) return {};
+    Block_Obj root = read<Block>();
+    if (root.isNull()) throw SerializationError("Missing root block");
+    if (pos != end) throw SerializationError("Unexpected trailing data");
+    return root;
+  }
+
+  AST_Node_Obj Deserializer::read_node()
+  {
+    const char* start = pos;
+    size_t tag = read_size();
+    if (tag == NO_NODE) return {};
+    if (depth == MAX_DEPTH) throw SerializationError("Nesting too deep");
+    // restored on return and on errors
+    struct Nesting {
+      size_t& depth;
+      Nesting(size_t& depth) : depth(depth) { ++depth; }
+      ~Nesting() { --depth; }
+    } nesting(depth);
+    SourceSpan span(read_span());
+    AST_Node_Obj node = read_fields(tag, span);
+    if (pos == end || *pos != check_byte(start, pos - start)) {
+      throw SerializationError("Damaged node");
+    }
+    ++pos;
+    return node;
+  }
+
+  AST_Node_Obj Deserializer::read_fields(size_t tag, const SourceSpan& span)
+  {
+    switch (tag) {
+
+      case BLOCK: {
+        Block_Obj node = SASS_MEMORY_NEW(Block, span);
+        read_statement(node);
+        node->is_root(read_bool());
+        read_elements(*node);
+        return node.ptr();
+      }
+
+      case STYLE_RULE: {
+        StyleRuleObj node = SASS_MEMORY_NEW(StyleRule, span);
+        read_statement(node);
+        node->block(read_required<Block>());
+        node->selector(read<SelectorList>());
+        node->schema(read<Selector_Schema>());
+        node->is_root(read_bool());
+        return node.ptr();
+      }
+
+      case BUBBLE: {
+        Bubble_Obj node = SASS_MEMORY_NEW(Bubble, span, Statement_Obj{});
+        read_statement(node);
+        node->node(read_required<Statement>());
+        node->group_end(read_bool());
+        return node.ptr();
+      }
+
+      case TRACE: {
+        Trace_Obj node = SASS_MEMORY_NEW(Trace, span, "");
+        read_statement(node);
+        node->block(read_required<Block>());
+        node->type(static_cast<char>(read_size()));
+        node->name(read_string());
+        return node.ptr();
+      }
+
+      case SUPPORTS_RULE: {
+        SupportsRuleObj node = SASS_MEMORY_NEW(SupportsRule, span, SupportsConditionObj{});
+        read_statement(node);
+        node->block(read_required<Block>());
+        node->condition(read_required<SupportsCondition>());
+        return node.ptr();
+      }
+
+      case MEDIA_RULE: {
+        MediaRuleObj node = SASS_MEMORY_NEW(MediaRule, span);
+        read_statement(node);
+        node->block(read_required<Block>());
+        node->schema(read_required<List>());
+        return node.ptr();
+      }
+
+      case CSS_MEDIA_RULE: {
+        CssMediaRuleObj node = SASS_MEMORY_NEW(CssMediaRule, span, Block_Obj{});
+        read_statement(node);
+        node->block(read_required<Block>());
+        read_elements(*node);
+        return node.ptr();
+      }
+
+      case CSS_MEDIA_QUERY: {
+        CssMediaQuery_Obj node = SASS_MEMORY_NEW(CssMediaQuery, span);
+        node->modifier(read_string());
+        node->type(read_string());
+        node->features(read_strings());
+        return node.ptr();
+      }
+
+      case AT_ROOT_RULE: {
+        AtRootRuleObj node = SASS_MEMORY_NEW(AtRootRule, span);
+        read_statement(node);
+        node->block(read_required<Block>());
+        node->expression(read<At_Root_Query>());
+        return node.ptr();
+      }
+
+      case AT_RULE: {
+        AtRuleObj node = SASS_MEMORY_NEW(AtRule, span, "");
+        read_statement(node);
+        node->block(read<Block>());
+        node->keyword(read_string());
+        node->selector(read<SelectorList>());
+        node->value(read<Expression>());
+        return node.ptr();
+      }
+
+      case KEYFRAME_RULE: {
+        Keyframe_Rule_Obj node = SASS_MEMORY_NEW(Keyframe_Rule, span, Block_Obj{});
+        read_statement(node);
+        node->block(read_required<Block>());
+        node->name(read<SelectorList>());
+        return node.ptr();
+      }
+
+      case DECLARATION: {
+        Declaration_Obj node = SASS_MEMORY_NEW(Declaration, span, String_Obj{}, ExpressionObj{});
+        read_statement(node);
+        node->block(read<Block>());
+        node->property(read_required<String>());
+        node->value(read<Expression>());
+        node->is_important(read_bool());
+        node->is_custom_property(read_bool());
+        node->is_indented(read_bool());
+        return node.ptr();
+      }
+
+      case ASSIGNMENT: {
+        Assignment_Obj node = SASS_MEMORY_NEW(Assignment, span, "", ExpressionObj{});
+        read_statement(node);
+        node->variable(read_string());
+        node->value(read_required<Expression>());
+        node->is_default(read_bool());
+        node->is_global(read_bool());
+        return node.ptr();
+      }
+
+      case IMPORT: {
+        Import_Obj node = SASS_MEMORY_NEW(Import, span);
+        read_statement(node);
+        for (size_t i = 0, S = read_size(); i < S; ++i) {
+          node->urls().push_back(read_required<Expression>());
+        }
+        for (size_t i = 0, S = read_size(); i < S; ++i) {
+          node->incs().push_back(read_include(span));
+        }
+        node->import_queries(read<List>());
+        return node.ptr();
+      }
+
+      case IMPORT_STUB: {
+        Import_Stub_Obj node = SASS_MEMORY_NEW(Import_Stub, span, read_include(span));
+        read_statement(node);
+        return node.ptr();
+      }
+
+      case WARNING_RULE: {
+        WarningRule_Obj node = SASS_MEMORY_NEW(WarningRule, span, ExpressionObj{});
+        read_statement(node);
+        node->message(read_required<Expression>());
+        return node.ptr();
+      }
+
+      case ERROR_RULE: {
+        ErrorRule_Obj node = SASS_MEMORY_NEW(ErrorRule, span, ExpressionObj{});
+        read_statement(node);
+        node->message(read_required<Expression>());
+        return node.ptr();
+      }
+
+      case DEBUG_RULE: {
+        DebugRule_Obj node = SASS_MEMORY_NEW(DebugRule, span, ExpressionObj{});
+        read_statement(node);
+        node->value(read_required<Expression>());
+        return node.ptr();
+      }
+
+      case COMMENT: {
+        Comment_Obj node = SASS_MEMORY_NEW(Comment, span, String_Obj{}, false);
+        read_statement(node);
+        node->text(read_required<String>());
+        node->is_important(read_bool());
+        return node.ptr();
+      }
+
+      case IF: {
+        If_Obj node = SASS_MEMORY_NEW(If, span, ExpressionObj{}, Block_Obj{});
+        read_statement(node);
+        node->block(read_required<Block>());
+        node->predicate(read_required<Expression>());
+        node->alternative(read<Block>());
+        return node.ptr();
+      }
+
+      case FOR_RULE: {
+        ForRuleObj node = SASS_MEMORY_NEW(ForRule, span, "", ExpressionObj{}, ExpressionObj{}, Block_Obj{}, false);
+        read_statement(node);
+        node->block(read_required<Block>());
+        node->variable(read_string());
+        node->lower_bound(read_required<Expression>());
+        node->upper_bound(read_required<Expression>());
+        node->is_inclusive(read_bool());
+        return node.ptr();
+      }
+
+      case EACH_RULE: {
+        EachRuleObj node = SASS_MEMORY_NEW(EachRule, span, sass::vector<sass::string>(), ExpressionObj{}, Block_Obj{});
+        read_statement(node);
+        node->block(read_required<Block>());
+        node->variables(read_strings());
+        node->list(read_required<Expression>());
+        return node.ptr();
+      }
+
+      case WHILE_RULE: {
+        WhileRuleObj node = SASS_MEMORY_NEW(WhileRule, span, ExpressionObj{}, Block_Obj{});
+        read_statement(node);
+        node->block(read_required<Block>());
+        node->predicate(read_required<Expression>());
+        return node.ptr();
+      }
+
+      case RETURN: {
+        Return_Obj node = SASS_MEMORY_NEW(Return, span, ExpressionObj{});
+        read_statement(node);
+        node->value(read_required<Expression>());
+        return node.ptr();
+      }
+
+      case CONTENT: {
+        Content_Obj node = SASS_MEMORY_NEW(Content, span, Arguments_Obj{});
+        read_statement(node);
+        node->arguments(read<Arguments>());
+        return node.ptr();
+      }
+
+      case EXTEND_RULE: {
+        ExtendRuleObj node = SASS_MEMORY_NEW(ExtendRule, span, SelectorListObj{});
+        read_statement(node);
+        node->isOptional(read_bool());
+        node->selector(read<SelectorList>());
+        node->schema(read<Selector_Schema>());
+        return node.ptr();
+      }
+
+      case DEFINITION: {
+        Definition_Obj node = SASS_MEMORY_NEW(Definition, span, "", Parameters_Obj{}, Block_Obj{}, Definition::MIXIN);
+        read_statement(node);
+        node->block(read_required<Block>());
+        node->name(read_string());
+        node->parameters(read_required<Parameters>());
+        node->type(read_enum(Definition::FUNCTION));
+        return node.ptr();
+      }
+
+      case MIXIN_CALL: {
+        Mixin_Call_Obj node = SASS_MEMORY_NEW(Mixin_Call, span, "", Arguments_Obj{});
+        read_statement(node);
+        node->block(read<Block>());
+        node->name(read_string());
+        node->arguments(read_required<Arguments>());
+        node->block_parameters(read<Parameters>());
+        return node.ptr();
+      }
+
+      case NULL_VALUE: {
+        Null_Obj node = SASS_MEMORY_NEW(Null, span);
+        read_expression(node);
+        return node.ptr();
+      }
+
+      case LIST: {
+        List_Obj node = SASS_MEMORY_NEW(List, span);
+        read_expression(node);
+        node->separator(read_enum(SASS_HASH));
+        node->is_arglist(read_bool());
+        node->is_bracketed(read_bool());
+        node->from_selector(read_bool());
+        read_elements(*node);
+        return node.ptr();
+      }
+
+      case MAP: {
+        Map_Obj node = SASS_MEMORY_NEW(Map, span);
+        read_expression(node);
+        for (size_t i = 0, S = read_size(); i < S; ++i) {
+          ExpressionObj key = read_required<Expression>();
+          ExpressionObj value = read_required<Expression>();
+          *node << std::make_pair(key, value);
+        }
+        // pushing it again marks it as duplicate
+        if (ExpressionObj key = read<Expression>()) {
+          *node << std::make_pair(key, read_required<Expression>());
+        }
+        return node.ptr();
+      }
+
+      case FUNCTION: {
+        Function_Obj node = SASS_MEMORY_NEW(Function, span, Definition_Obj{}, false);
+        read_expression(node);
+        node->definition(read_required<Definition>());
+        node->is_css(read_bool());
+        return node.ptr();
+      }
+
+      case BINARY_EXPRESSION: {
+        Binary_Expression_Obj node = SASS_MEMORY_NEW(Binary_Expression, span,
+          Operand(Sass_OP::ADD), ExpressionObj{}, ExpressionObj{});
+        read_expression(node);
+        Sass_OP operand = read_enum(Sass_OP::MOD);
+        bool ws_before = read_bool();
+        bool ws_after = read_bool();
+        node->op(Operand(operand, ws_before, ws_after));
+        node->left(read_required<Expression>());
+        node->right(read_required<Expression>());
+        return node.ptr();
+      }
+
+      case UNARY_EXPRESSION: {
+        Unary_Expression_Obj node = SASS_MEMORY_NEW(Unary_Expression, span,
+          Unary_Expression::PLUS, ExpressionObj{});
+        read_expression(node);
+        node->optype(read_enum(Unary_Expression::SLASH));
+        node->operand(read_required<Expression>());
+        return node.ptr();
+      }
+
+      case FUNCTION_CALL: {
+        Function_Call_Obj node = SASS_MEMORY_NEW(Function_Call, span, String_Obj{}, Arguments_Obj{});
+        read_expression(node);
+        node->sname(read_required<String>());
+        node->arguments(read_required<Arguments>());
+        node->via_call(read_bool());
+        return node.ptr();
+      }
+
+      case CUSTOM_WARNING: {
+        Custom_Warning_Obj node = SASS_MEMORY_NEW(Custom_Warning, span, "");
+        read_expression(node);
+        node->message(read_string());
+        return node.ptr();
+      }
+
+      case CUSTOM_ERROR: {
+        Custom_Error_Obj node = SASS_MEMORY_NEW(Custom_Error, span, "");
+        read_expression(node);
+        node->message(read_string());
+        return node.ptr();
+      }
+
+      case VARIABLE: {
+        Variable_Obj node = SASS_MEMORY_NEW(Variable, span, "");
+        read_expression(node);
+        node->name(read_string());
+        return node.ptr();
+      }
+
+      case NUMBER: {
+        Number_Obj node = SASS_MEMORY_NEW(Number, span, 0);
+        read_expression(node);
+        node->value(read_double());
+        node->zero(read_bool());
+        node->numerators = read_units();
+        node->denominators = read_units();
+        return node.ptr();
+      }
+
+      case COLOR_RGBA: {
+        Color_RGBA_Obj node = SASS_MEMORY_NEW(Color_RGBA, span, 0, 0, 0);
+        read_expression(node);
+        node->disp(read_string());
+        node->a(read_double());
+        node->r(read_double());
+        node->g(read_double());
+        node->b(read_double());
+        return node.ptr();
+      }
+
+      case COLOR_HSLA: {
+        Color_HSLA_Obj node = SASS_MEMORY_NEW(Color_HSLA, span, 0, 0, 0);
+        read_expression(node);
+        node->disp(read_string());
+        node->a(read_double());
+        node->h(read_double());
+        node->s(read_double());
+        node->l(read_double());
+        return node.ptr();
+      }
+
+      case BOOLEAN: {
+        Boolean_Obj node = SASS_MEMORY_NEW(Boolean, span, false);
+        read_expression(node);
+        node->value(read_bool());
+        return node.ptr();
+      }
+
+      case STRING_SCHEMA: {
+        String_Schema_Obj node = SASS_MEMORY_NEW(String_Schema, span);
+        read_expression(node);
+        node->css(read_bool());
+        read_elements(*node);
+        return node.ptr();
+      }
+
+      case STRING_CONSTANT: {
+        String_Constant_Obj node = SASS_MEMORY_NEW(String_Constant, span, "");
+        read_expression(node);
+        node->quote_mark(static_cast<char>(read_size()));
+        node->value(read_string());
+        return node.ptr();
+      }
+
+      case STRING_QUOTED: {
+        String_Quoted_Obj node = SASS_MEMORY_NEW(String_Quoted, span, "", 0, false, true);
+        read_expression(node);
+        node->quote_mark(static_cast<char>(read_size()));
+        node->value(read_string());
+        return node.ptr();
+      }
+
+      case SUPPORTS_OPERATION: {
+        SupportsOperationObj node = SASS_MEMORY_NEW(SupportsOperation, span,
+          SupportsConditionObj{}, SupportsConditionObj{}, SupportsOperation::AND);
+        read_expression(node);
+        node->left(read_required<SupportsCondition>());
+        node->right(read_required<SupportsCondition>());
+        node->operand(read_enum(SupportsOperation::OR));
+        return node.ptr();
+      }
+
+      case SUPPORTS_NEGATION: {
+        SupportsNegationObj node = SASS_MEMORY_NEW(SupportsNegation, span, SupportsConditionObj{});
+        read_expression(node);
+        node->condition(read_required<SupportsCondition>());
+        return node.ptr();
+      }
+
+      case SUPPORTS_DECLARATION: {
+        SupportsDeclarationObj node = SASS_MEMORY_NEW(SupportsDeclaration, span, ExpressionObj{}, ExpressionObj{});
+        read_expression(node);
+        node->feature(read_required<Expression>());
+        node->value(read_required<Expression>());
+        return node.ptr();
+      }
+
+      case SUPPORTS_INTERPOLATION: {
+        Supports_Interpolation_Obj node = SASS_MEMORY_NEW(Supports_Interpolation, span, ExpressionObj{});
+        read_expression(node);
+        node->value(read_required<Expression>());
+        return node.ptr();
+      }
+
+      case MEDIA_QUERY: {
+        Media_Query_Obj node = SASS_MEMORY_NEW(Media_Query, span);
+        read_expression(node);
+        node->media_type(read<String>());
+        node->is_negated(read_bool());
+        node->is_restricted(read_bool());
+        read_elements(*node);
+        return node.ptr();
+      }
+
+      case MEDIA_QUERY_EXPRESSION: {
+        Media_Query_Expression_Obj node = SASS_MEMORY_NEW(Media_Query_Expression, span, ExpressionObj{}, ExpressionObj{});
+        read_expression(node);
+        node->feature(read_required<Expression>());
+        node->value(read<Expression>());
+        node->is_interpolated(read_bool());
+        return node.ptr();
+      }
+
+      case AT_ROOT_QUERY: {
+        At_Root_Query_Obj node = SASS_MEMORY_NEW(At_Root_Query, span);
+        read_expression(node);
+        node->feature(read<Expression>());
+        node->value(read<Expression>());
+        return node.ptr();
+      }
+
+      case PARENT_REFERENCE: {
+        Parent_Reference_Obj node = SASS_MEMORY_NEW(Parent_Reference, span);
+        read_expression(node);
+        return node.ptr();
+      }
+
+      case PARAMETER: {
+        Parameter_Obj node = SASS_MEMORY_NEW(Parameter, span, "");
+        node->name(read_string());
+        node->default_value(read<Expression>());
+        node->is_rest_parameter(read_bool());
+        return node.ptr();
+      }
+
+      case PARAMETERS: {
+        Parameters_Obj node = SASS_MEMORY_NEW(Parameters, span);
+        node->has_optional_parameters(read_bool());
+        node->has_rest_parameter(read_bool());
+        read_elements(*node);
+        // the flags must match the parameters (as when pushed)
+        bool optional = false, rest = false;
+        for (const Parameter_Obj& param : node->elements()) {
+          if (param->default_value()) optional = true;
+          else if (param->is_rest_parameter()) rest = true;
+        }
+        if (optional != node->has_optional_parameters() || rest != node->has_rest_parameter()) {
+          throw SerializationError("Invalid parameters");
+        }
+        return node.ptr();
+      }
+
+      case ARGUMENT: {
+        Argument_Obj node = SASS_MEMORY_NEW(Argument, span, ExpressionObj{});
+        read_expression(node);
+        node->value(read_required<Expression>());
+        node->name(read_string());
+        node->is_rest_argument(read_bool());
+        node->is_keyword_argument(read_bool());
+        return node.ptr();
+      }
+
+      case ARGUMENTS: {
+        Arguments_Obj node = SASS_MEMORY_NEW(Arguments, span);
+        read_expression(node);
+        node->has_named_arguments(read_bool());
+        node->has_rest_argument(read_bool());
+        node->has_keyword_argument(read_bool());
+        read_elements(*node);
+        // the flags must match the arguments (as when pushed)
+        bool named = false, rest = false, keyword = false;
+        for (const Argument_Obj& arg : node->elements()) {
+          if (!arg->name().empty()) named = true;
+          else if (arg->is_rest_argument()) rest = true;
+          else if (arg->is_keyword_argument()) keyword = true;
+        }
+        if (named != node->has_named_arguments() || rest != node->has_rest_argument() ||
+            keyword != node->has_keyword_argument()) {
+          throw SerializationError("Invalid arguments");
+        }
+        return node.ptr();
+      }
+
+      case SELECTOR_SCHEMA: {
+        Selector_Schema_Obj node = SASS_MEMORY_NEW(Selector_Schema, span, String_Obj{});
+        node->contents(read_required<String_Schema>());
+        node->connect_parent(read_bool());
+        return node.ptr();
+      }
+
+      case PLACEHOLDER_SELECTOR: {
+        PlaceholderSelectorObj node = SASS_MEMORY_NEW(PlaceholderSelector, span, "");
+        read_simple(node);
+        return node.ptr();
+      }
+
+      case TYPE_SELECTOR: {
+        TypeSelectorObj node = SASS_MEMORY_NEW(TypeSelector, span, "");
+        read_simple(node);
+        return node.ptr();
+      }
+
+      case CLASS_SELECTOR: {
+        ClassSelectorObj node = SASS_MEMORY_NEW(ClassSelector, span, "");
+        read_simple(node);
+        return node.ptr();
+      }
+
+      case ID_SELECTOR: {
+        IDSelectorObj node = SASS_MEMORY_NEW(IDSelector, span, "");
+        read_simple(node);
+        return node.ptr();
+      }
+
+      case ATTRIBUTE_SELECTOR: {
+        AttributeSelectorObj node = SASS_MEMORY_NEW(AttributeSelector, span, "", "", String_Obj{});
+        read_simple(node);
+        node->matcher(read_string());
+        node->value(read<String>());
+        node->modifier(static_cast<char>(read_size()));
+        return node.ptr();
+      }
+
+      case PSEUDO_SELECTOR: {
+        PseudoSelectorObj node = SASS_MEMORY_NEW(PseudoSelector, span, "");
+        read_simple(node);
+        node->normalized(read_string());
+        node->argument(read<String>());
+        node->selector(read<SelectorList>());
+        node->isSyntacticClass(read_bool());
+        node->isClass(read_bool());
+        return node.ptr();
+      }
+
+      case SELECTOR_COMBINATOR: {
+        SelectorCombinatorObj node = SASS_MEMORY_NEW(SelectorCombinator, span, SelectorCombinator::CHILD);
+        read_expression(node);
+        node->hasPostLineBreak(read_bool());
+        node->combinator(read_enum(SelectorCombinator::ADJACENT));
+        return node.ptr();
+      }
+
+      case COMPOUND_SELECTOR: {
+        CompoundSelectorObj node = SASS_MEMORY_NEW(CompoundSelector, span);
+        read_expression(node);
+        node->hasPostLineBreak(read_bool());
+        node->hasRealParent(read_bool());
+        node->extended(read_bool());
+        read_elements(*node);
+        return node.ptr();
+      }
+
+      case COMPLEX_SELECTOR: {
+        ComplexSelectorObj node = SASS_MEMORY_NEW(ComplexSelector, span);
+        read_expression(node);
+        node->chroots(read_bool());
+        node->hasPreLineFeed(read_bool());
+        read_elements(*node);
+        return node.ptr();
+      }
+
+      case SELECTOR_LIST: {
+        SelectorListObj node = SASS_MEMORY_NEW(SelectorList, span);
+        read_expression(node);
+        node->is_optional(read_bool());
+        read_elements(*node);
+        return node.ptr();
+      }
+
+    }
+
+    throw SerializationError("Unknown node tag");
+  }
+
+  /////////////////////////////////////////////////////////////////////////
+  /////////////////////////////////////////////////////////////////////////
+
+  sass::string precompiled_path(const sass::string& path)
+  {
+    // keep the extension, `a.scss` and `a.sass` may both exist
+    return path + ".sassc";
+  }
+
+  // Using `<cstdio>` for the same reasons as `File::read_file`
+  bool read_precompiled(const sass::string& path, sass::string& data)
+  {
+    FILE* fd = std::fopen(path.c_str(), "rb");
+    if (fd == nullptr) return false;
+    char chunk[4096];
+    size_t size;
+    while ((size = std::fread(chunk, 1, sizeof(chunk), fd)) > 0) {
+      data.append(chunk, size);
+    }
+    bool ok = !std::ferror(fd);
+    std::fclose(fd);
+    return ok;
+  }
+
+  bool write_precompiled(const sass::string& path, const sass::string& data)
+  {
+    FILE* fd = std::fopen(path.c_str(), "wb");
+    if (fd == nullptr) return false;
+    bool ok = std::fwrite(data.data(), 1, data.size(), fd) == data.size();
+    return std::fclose(fd) == 0 && ok;
+  }
+
+}
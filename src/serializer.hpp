@@ -0,0 +1,253 @@
+#ifndef SASS_SERIALIZER_H
+#define SASS_SERIALIZER_H
+
+// sass.hpp must go before all system headers to get the
+// __EXTENSIONS__ fix on Solaris.
+#include "sass.hpp"
+
+#include <map>
+#include <stdexcept>
+
+#include "ast.hpp"
+#include "operation.hpp"
+#include "position.hpp"
+#include "file.hpp"
+
+///////////////////////////////////////////////////////////////////////////////
+// Binary format for parsed stylesheets. A precompiled tree is stored in a
+// sidecar next to its source (`_tokens.scss` -> `_tokens.scss.sassc`) and loaded
+// instead of parsing the source again. The header holds a format version
+// plus the length and hash of the source it was parsed from; sidecars not
+// matching the current source are ignored. The data ends with a checksum
+// (FNV-1a over all bytes before it, little endian), so damaged sidecars are
+// ignored too, as is any invalid tree (the source is parsed). Every node ends
+// with a check byte over its data and spans must lie within the source, so
+// damage the checksum misses is still caught (as are most changes to the
+// data sealed again). All spans are stored relative to that source, so the
+// tree points into the loaded resource.
+// Imports are stored by the path written in the stylesheet and resolved again
+// when loading the tree.
+///////////////////////////////////////////////////////////////////////////////
+
+namespace Sass {
+
+  // Thrown for trees we can't store and data we can't read
+  class SerializationError : public std::runtime_error {
+    public:
+      SerializationError(const sass::string& msg)
+      : std::runtime_error(msg)
+      { }
+  };
+
+  class Serializer : public Operation_CRTP<void, Serializer> {
+
+    private:
+
+      sass::string buffer;
+
+      void write_size(size_t value);
+      void write_bool(bool value);
+      void write_double(double value);
+      void write_string(const sass::string& value);
+      void write_strings(const sass::vector<sass::string>& values);
+      void write_units(const UnitList& units);
+      void write_span(const SourceSpan& pstate);
+      void write_include(const Include& include);
+      void write_node(size_t tag, AST_Node* node);
+      void write_statement(Statement* node);
+      void write_expression(Expression* node);
+      void write_simple(SimpleSelector* node);
+
+      template <class T, class V>
+      void write_elements(const Vectorized<T, V>& vec)
+      {
+        write_size(vec.length());
+        for (const T& item : vec.elements()) write(item.ptr());
+      }
+
+    public:
+
+      // writes the header for the given source
+      Serializer(const char* source);
+      ~Serializer() { }
+
+      // serialize the node (may be null)
+      void write(AST_Node* node);
+
+      // the serialized data so far (with its checksum)
+      sass::string data() const;
+
+      // statements
+      void operator()(Block*);
+      void operator()(StyleRule*);
+      void operator()(Bubble*);
+      void operator()(Trace*);
+      void operator()(SupportsRule*);
+      void operator()(MediaRule*);
+      void operator()(CssMediaRule*);
+      void operator()(CssMediaQuery*);
+      void operator()(AtRootRule*);
+      void operator()(AtRule*);
+      void operator()(Keyframe_Rule*);
+      void operator()(Declaration*);
+      void operator()(Assignment*);
+      void operator()(Import*);
+      void operator()(Import_Stub*);
+      void operator()(WarningRule*);
+      void operator()(ErrorRule*);
+      void operator()(DebugRule*);
+      void operator()(Comment*);
+      void operator()(If*);
+      void operator()(ForRule*);
+      void operator()(EachRule*);
+      void operator()(WhileRule*);
+      void operator()(Return*);
+      void operator()(Content*);
+      void operator()(ExtendRule*);
+      void operator()(Definition*);
+      void operator()(Mixin_Call*);
+      // expressions
+      void operator()(Null*);
+      void operator()(List*);
+      void operator()(Map*);
+      void operator()(Function*);
+      void operator()(Binary_Expression*);
+      void operator()(Unary_Expression*);
+      void operator()(Function_Call*);
+      void operator()(Custom_Warning*);
+      void operator()(Custom_Error*);
+      void operator()(Variable*);
+      void operator()(Number*);
+      void operator()(Color_RGBA*);
+      void operator()(Color_HSLA*);
+      void operator()(Boolean*);
+      void operator()(String_Schema*);
+      void operator()(String_Constant*);
+      void operator()(String_Quoted*);
+      void operator()(SupportsOperation*);
+      void operator()(SupportsNegation*);
+      void operator()(SupportsDeclaration*);
+      void operator()(Supports_Interpolation*);
+      void operator()(Media_Query*);
+      void operator()(Media_Query_Expression*);
+      void operator()(At_Root_Query*);
+      void operator()(Parent_Reference*);
+      // parameters and arguments
+      void operator()(Parameter*);
+      void operator()(Parameters*);
+      void operator()(Argument*);
+      void operator()(Arguments*);
+      // selectors
+      void operator()(Selector_Schema*);
+      void operator()(PlaceholderSelector*);
+      void operator()(TypeSelector*);
+      void operator()(ClassSelector*);
+      void operator()(IDSelector*);
+      void operator()(AttributeSelector*);
+      void operator()(PseudoSelector*);
+      void operator()(SelectorCombinator*);
+      void operator()(CompoundSelector*);
+      void operator()(ComplexSelector*);
+      void operator()(SelectorList*);
+
+      // anything else is only created during evaluation
+      template <typename U>
+      void fallback(U x) {
+        throw SerializationError("Unable to serialize " + sass::string(typeid(*x).name()));
+      }
+
+  };
+
+  class Deserializer {
+
+    private:
+
+      Context& ctx;
+      const char* pos;
+      const char* end;
+      // span of the loaded resource
+      SourceSpan pstate;
+      size_t length;
+      // of every line, to check the spans
+      sass::vector<size_t> widths;
+      // imports resolved so far (by stored path)
+      std::map<sass::string, Include> includes;
+      // nesting of the node currently read
+      size_t depth;
+
+      size_t read_size();
+      bool read_bool();
+      double read_double();
+      sass::string read_string();
+      sass::vector<sass::string> read_strings();
+      UnitList read_units();
+      SourceSpan read_span();
+      Include read_include(const SourceSpan& pstate);
+      AST_Node_Obj read_node();
+      AST_Node_Obj read_fields(size_t tag, const SourceSpan& span);
+      void read_statement(Statement* node);
+      void read_expression(Expression* node);
+      void read_simple(SimpleSelector* node);
+
+      template <class E>
+      E read_enum(E last)
+      {
+        size_t value = read_size();
+        if (value > size_t(last)) throw SerializationError("Invalid enum value");
+        return static_cast<E>(value);
+      }
+
+      template <class T>
+      SharedImpl<T> read()
+      {
+        AST_Node_Obj node = read_node();
+        if (node.isNull()) return {};
+        T* typed = Cast<T>(node.ptr());
+        if (typed == nullptr) throw SerializationError("Unexpected node type");
+        return typed;
+      }
+
+      // for children the tree can't do without
+      template <class T>
+      SharedImpl<T> read_required()
+      {
+        SharedImpl<T> node = read<T>();
+        if (node.isNull()) throw SerializationError("Missing node");
+        return node;
+      }
+
+      template <class T, class V>
+      void read_elements(Vectorized<SharedImpl<T>, V>& vec)
+      {
+        size_t size = read_size();
+        // don't trust the size for reserving
+        for (size_t i = 0; i < size; ++i) {
+          // bypass `adjust_after_pushing`, flags are stored
+          vec.elements().push_back(read_required<T>());
+        }
+      }
+
+    public:
+
+      // pstate of the resource the data belongs to
+      Deserializer(Context& ctx, const sass::string& data, const SourceSpan& pstate);
+      ~Deserializer() { }
+
+      // returns null if the data was written for another source
+      // or is damaged, throws SerializationError if it is invalid
+      Block_Obj read_root();
+
+  };
+
+  // Path of the sidecar holding the precompiled tree
+  sass::string precompiled_path(const sass::string& path);
+
+  // Read the whole sidecar; false if there is none
+  bool read_precompiled(const sass::string& path, sass::string& data);
+
+  // Store the data in the sidecar; false on failure
+  bool write_precompiled(const sass::string& path, const sass::string& data);
+
+}
+
+#endif
@@ -0,0 +1,153 @@
+#ifndef SASS_SHARED_VECTOR_H
+#define SASS_SHARED_VECTOR_H
+
+// sass.hpp must go before all system headers to get the
+// __EXTENSIONS__ fix on Solaris.
+#include "sass.hpp"
+
+#include <memory>
+#include <iterator>
+#include <algorithm>
+#include <stdexcept>
+
+namespace Sass {
+
+  // ##########################################################################
+  // Vector whose buffer is shared by its copies until one of them changes
+  // (copy on write). A copy ending where the shared buffer ends appends in
+  // place while the buffer has room, the other copies never look past their
+  // own length. Used for the elements of list values, so building a list
+  // one element at a time from copies is amortized O(1) per element.
+  // Copies are meant to stay on one thread (like the AST nodes using them).
+  // Elements are only read through const references (also when non-const),
+  // so reading never copies the buffer and no reference handed out can
+  // reach a later copy. They are changed by `set` and the modifiers.
+  // ##########################################################################
+  template <class T>
+  class shared_vector {
+
+  public:
+
+    typedef T value_type;
+    typedef const T& reference;
+    typedef const T& const_reference;
+    typedef typename sass::vector<T>::const_iterator iterator;
+    typedef typename sass::vector<T>::const_iterator const_iterator;
+
+  private:
+
+    std::shared_ptr<sass::vector<T>> buffer_;
+    // Elements of the buffer belonging to this copy
+    size_t length_;
+
+    // Makes the buffer ours alone, with exactly our elements
+    sass::vector<T>& owned()
+    {
+      if (!buffer_) {
+        buffer_ = std::make_shared<sass::vector<T>>();
+      }
+      else if (buffer_.use_count() > 1) {
+        buffer_ = std::make_shared<sass::vector<T>>(cbegin(), cend());
+      }
+      else if (buffer_->size() != length_) {
+        buffer_->erase(buffer_->begin() + length_, buffer_->end());
+      }
+      return *buffer_;
+    }
+
+  public:
+
+    shared_vector() : buffer_(), length_(0) { }
+    shared_vector(sass::vector<T> elements)
+    : buffer_(std::make_shared<sass::vector<T>>(std::move(elements))),
+      length_(buffer_->size())
+    { }
+
+    size_t size() const { return length_; }
+    bool empty() const { return length_ == 0; }
+
+    const_iterator cbegin() const
+    {
+      static const sass::vector<T> none;
+      return buffer_ ? buffer_->cbegin() : none.cbegin();
+    }
+    const_iterator cend() const { return cbegin() + length_; }
+    const_iterator begin() const { return cbegin(); }
+    const_iterator end() const { return cend(); }
+
+    const T& operator[](size_t i) const { return cbegin()[i]; }
+    const T& front() const { return cbegin()[0]; }
+    const T& back() const { return cbegin()[length_ - 1]; }
+    const T& at(size_t i) const
+    {
+      if (i >= length_) throw std::out_of_range("shared_vector::at");
+      return cbegin()[i];
+    }
+    // Replaces the element at [i], in a buffer of our own
+    void set(size_t i, const T& element)
+    {
+      owned()[i] = element;
+    }
+
+    void reserve(size_t capacity)
+    {
+      if (capacity > length_) owned().reserve(capacity);
+    }
+
+    void clear()
+    {
+      buffer_.reset();
+      length_ = 0;
+    }
+
+    void push_back(const T& element)
+    {
+      insert(cend(), &element, &element + 1);
+    }
+
+    iterator insert(const_iterator position, const T& element)
+    {
+      return insert(position, &element, &element + 1);
+    }
+
+    // Appends in place if we end where the buffer ends and it has room
+    // (shared or not), otherwise copies our elements with room to grow.
+    // The range may be part of the buffer, it is still intact when read.
+    template <class I>
+    iterator insert(const_iterator position, I first, I last)
+    {
+      size_t index = position - cbegin();
+      size_t count = std::distance(first, last);
+      if (index == length_ && buffer_ && length_ + count <= buffer_->capacity() &&
+          (buffer_.use_count() == 1 || buffer_->size() == length_)) {
+        // drops the elements of copies that are gone
+        sass::vector<T>& elements = *buffer_;
+        elements.erase(elements.begin() + length_, elements.end());
+        // no reallocation, so the range stays valid
+        for (; first != last; ++first) elements.push_back(*first);
+        length_ += count;
+        return elements.begin() + index;
+      }
+      auto grown = std::make_shared<sass::vector<T>>();
+      grown->reserve(std::max<size_t>((length_ + count) * 2, 4));
+      grown->insert(grown->end(), cbegin(), cbegin() + index);
+      grown->insert(grown->end(), first, last);
+      grown->insert(grown->end(), cbegin() + index, cend());
+      buffer_ = std::move(grown);
+      length_ += count;
+      return buffer_->begin() + index;
+    }
+
+    iterator erase(const_iterator position)
+    {
+      size_t index = position - cbegin();
+      sass::vector<T>& elements = owned();
+      --length_;
+      return elements.erase(elements.begin() + index);
+    }
+
+  };
+
+}
+
+#endif
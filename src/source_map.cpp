@@ -14,8 +14,8 @@
 #include "source_map.hpp"
 
 namespace Sass {
-  SourceMap::SourceMap() : current_position(0, 0, 0), file("stdin") { }
-  SourceMap::SourceMap(const sass::string& file) : current_position(0, 0, 0), file(file) { }
+  SourceMap::SourceMap() : current_position(0, 0, 0), prefix(0, 0), file("stdin") { }
+  SourceMap::SourceMap(const sass::string& file) : current_position(0, 0, 0), prefix(0, 0), file(file) { }
 
   sass::string SourceMap::render_srcmap(Context &ctx) {
 
@@ -91,12 +91,15 @@ namespace Sass {
     size_t previous_original_line = 0;
     size_t previous_original_column = 0;
     size_t previous_original_file = 0;
-    for (size_t i = 0; i < mappings.size(); ++i) {
-      const size_t generated_line = mappings[i].generated_position.line;
-      const size_t generated_column = mappings[i].generated_position.column;
-      const size_t original_line = mappings[i].original_position.line;
-      const size_t original_column = mappings[i].original_position.column;
-      const size_t original_file = mappings[i].original_position.file;
+    const size_t prefixed = prefix_mappings.size();
+    for (size_t i = 0; i < prefixed + mappings.size(); ++i) {
+      const Mapping& mapping = i < prefixed ? prefix_mappings[i] : mappings[i - prefixed];
+      const Position generated = i < prefixed ? mapping.generated_position : shifted(mapping.generated_position);
+      const size_t generated_line = generated.line;
+      const size_t generated_column = generated.column;
+      const size_t original_line = mapping.original_position.line;
+      const size_t original_column = mapping.original_position.column;
+      const size_t original_file = mapping.original_position.file;
 
       if (generated_line != previous_generated_line) {
         previous_generated_column = 0;
@@ -142,7 +145,14 @@ namespace Sass {
     // adjust the buffer offset
     prepend(Offset(out.buffer));
     // now add the new mappings
-    VECTOR_UNSHIFT(mappings, out.smap.mappings);
+    sass::vector<Mapping> head(out.smap.prefix_mappings);
+    head.reserve(head.size() + out.smap.mappings.size() + prefix_mappings.size());
+    for (Mapping mapping : out.smap.mappings) {
+      mapping.generated_position = out.smap.shifted(mapping.generated_position);
+      head.push_back(mapping);
+    }
+    VECTOR_PUSH(head, prefix_mappings);
+    prefix_mappings.swap(head);
   }
 
   void SourceMap::append(const OutputBuffer& out)
@@ -153,19 +163,20 @@ namespace Sass {
   void SourceMap::prepend(const Offset& offset)
   {
     if (offset.line != 0 || offset.column != 0) {
-      for (Mapping& mapping : mappings) {
-        // move stuff on the first old line
-        if (mapping.generated_position.line == 0) {
-          mapping.generated_position.column += offset.column;
-        }
-        // make place for the new lines
-        mapping.generated_position.line += offset.line;
+      // only the prefix moves, [mappings]
+      // are shifted once they are rendered
+      for (Mapping& mapping : prefix_mappings) {
+        mapping.generated_position = Position(
+          mapping.generated_position.file,
+          offset + mapping.generated_position);
       }
+      prefix = offset + prefix;
     }
-    if (current_position.line == 0) {
-      current_position.column += offset.column;
-    }
-    current_position.line += offset.line;
+  }
+
+  Position SourceMap::shifted(const Position& generated) const
+  {
+    return Position(generated.file, prefix + generated);
   }
 
   void SourceMap::append(const Offset& offset)
@@ -184,12 +195,20 @@ namespace Sass {
   }
 
   SourceSpan SourceMap::remap(const SourceSpan& pstate) {
-    for (size_t i = 0; i < mappings.size(); ++i) {
+    for (const Mapping& mapping : prefix_mappings) {
+      if (
+        mapping.generated_position.file == pstate.file &&
+        mapping.generated_position.line == pstate.line &&
+        mapping.generated_position.column == pstate.column
+      ) return SourceSpan(pstate.path, pstate.src, mapping.original_position, pstate.offset);
+    }
+    for (const Mapping& mapping : mappings) {
+      const Position generated(shifted(mapping.generated_position));
       if (
-        mappings[i].generated_position.file == pstate.file &&
-        mappings[i].generated_position.line == pstate.line &&
-        mappings[i].generated_position.column == pstate.column
-      ) return SourceSpan(pstate.path, pstate.src, mappings[i].original_position, pstate.offset);
+        generated.file == pstate.file &&
+        generated.line == pstate.line &&
+        generated.column == pstate.column
+      ) return SourceSpan(pstate.path, pstate.src, mapping.original_position, pstate.offset);
     }
     return SourceSpan(pstate.path, pstate.src, Position(-1, -1, -1), Offset(0, 0));
 
@@ -10,7 +10,6 @@
 #include "mapping.hpp"
 
 #define VECTOR_PUSH(vec, ins) vec.insert(vec.end(), ins.begin(), ins.end())
-#define VECTOR_UNSHIFT(vec, ins) vec.insert(vec.begin(), ins.begin(), ins.end())
 
 namespace Sass {
 
@@ -37,9 +36,15 @@ namespace Sass {
   private:
 
     sass::string serialize_mappings();
+    // generated position of a mapping placed after [prefix]
+    Position shifted(const Position& generated) const;
 
     sass::vector<Mapping> mappings;
     Position current_position;
+    // Output that goes in front of the mapped one. It is kept
+    // apart so prepending never moves or adjusts [mappings].
+    sass::vector<Mapping> prefix_mappings;
+    Offset prefix;
 public:
     sass::string file;
 private:
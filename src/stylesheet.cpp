@@ -4,6 +4,10 @@
 
 #include "stylesheet.hpp"
 
+#include <cstdio>
+#include <mutex>
+#include <unordered_map>
+
 namespace Sass {
 
   // Constructor
@@ -19,4 +23,51 @@ namespace Sass {
   {
   }
 
+  namespace {
+
+    struct Entry {
+      int64_t mtime;
+      StyleSheetCache::Data data;
+    };
+
+    // shared by all compilations
+    std::mutex mutex;
+    std::unordered_map<sass::string, Entry> entries;
+
+  }
+
+  StyleSheetCache::Data StyleSheetCache::find(const sass::string& abs_path, int64_t mtime)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = entries.find(abs_path);
+    if (it == entries.end() || it->second.mtime != mtime) return {};
+    return it->second.data;
+  }
+
+  void StyleSheetCache::insert(const sass::string& abs_path, int64_t mtime, Data data)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    entries[abs_path] = { mtime, std::move(data) };
+  }
+
+  void StyleSheetCache::clear()
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    entries.clear();
+  }
+
+  // named by a hash of the path (FNV-1a), other files with
+  // the same hash are told apart by the hash of their source
+  sass::string StyleSheetCache::stored_path(const sass::string& dir, const sass::string& abs_path)
+  {
+    uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char c : abs_path) {
+      hash ^= c;
+      hash *= 1099511628211ULL;
+    }
+    char name[24];
+    std::snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(hash));
+    return File::join_paths(dir, sass::string(name) + ".sassc");
+  }
+
 }
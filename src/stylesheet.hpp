@@ -9,6 +9,9 @@
 #include "extender.hpp"
 #include "file.hpp"
 
+#include <cstdint>
+#include <memory>
+
 namespace Sass {
 
   // parsed stylesheet from loaded resource
@@ -51,6 +54,36 @@ namespace Sass {
 
   };
 
+  // Opt-in cache of parsed stylesheets, shared by all compilations of the
+  // process. Trees are kept in the binary format of `serializer.hpp`, so
+  // every compilation loads nodes of its own (AST nodes are not thread
+  // safe) with spans into its own resources, and resolves the imports of
+  // the tree again with its own include paths. Entries are keyed by the
+  // absolute path and the modification time of the file. Entries of files
+  // with another modification time are replaced by the next compilation
+  // parsing the file; changes within the same second are caught by the
+  // length and hash of the source stored in the data. Entries are kept
+  // until `clear` is called. They can also be stored in a directory, so
+  // later processes find them as well.
+  class StyleSheetCache {
+
+    public:
+
+      typedef std::shared_ptr<const sass::string> Data;
+
+      // Get the tree of the file with the given modification time (or null)
+      static Data find(const sass::string& abs_path, int64_t mtime);
+
+      // Add the tree of the file (replaces any existing one)
+      static void insert(const sass::string& abs_path, int64_t mtime, Data data);
+
+      // Remove all entries (not those stored in directories)
+      static void clear();
+
+      // Where the tree of the file is stored in the given directory
+      static sass::string stored_path(const sass::string& dir, const sass::string& abs_path);
+
+  };
 
 }
 
@@ -0,0 +1,99 @@
+// sass.hpp must go before all system headers to get the
+// __EXTENSIONS__ fix on Solaris.
+#include "sass.hpp"
+
+#include "symbol.hpp"
+
+#include <mutex>
+#include <unordered_map>
+
+namespace Sass {
+
+  namespace {
+
+    typedef std::unordered_map<sass::string, Symbol::Data> SymbolTable;
+
+    // The table is split by hash into shards with a lock of their
+    // own, so concurrent compilations rarely wait for each other.
+    struct Shard {
+      std::mutex mutex;
+      SymbolTable table;
+    };
+
+    const size_t SHARDS = 64;
+
+    Shard& shard(size_t hash)
+    {
+      // never destroyed, symbols may outlive static destructors
+      static Shard* shards = new Shard[SHARDS];
+      // the low bits select the bucket inside the shard
+      return shards[(hash >> 16) % SHARDS];
+    }
+
+    // nodes of the table never move, so entries can be handed
+    // out while it changes; counts the new reference if found
+    Symbol::Entry* lookup(const sass::string& str, bool insert)
+    {
+      if (str.empty()) return nullptr;
+      size_t hash = std::hash<sass::string>()(str);
+      Shard& entries = shard(hash);
+      std::lock_guard<std::mutex> lock(entries.mutex);
+      auto it = entries.table.find(str);
+      if (it != entries.table.end()) {
+        it->second.refs.fetch_add(1, std::memory_order_relaxed);
+      }
+      else if (insert) {
+        it = entries.table.emplace(std::piecewise_construct,
+          std::forward_as_tuple(str), std::forward_as_tuple(hash)).first;
+      }
+      else {
+        return nullptr;
+      }
+      return &*it;
+    }
+
+  }
+
+  Symbol::Symbol(const char* str)
+  : entry_(lookup(str, true))
+  { }
+
+  Symbol::Symbol(const sass::string& str)
+  : entry_(lookup(str, true))
+  { }
+
+  Symbol Symbol::find(const sass::string& str)
+  {
+    return Symbol(lookup(str, false));
+  }
+
+  // Counts only drop to zero under the lock of the shard, lookups
+  // only count under it too, so they never see a dropped entry.
+  void Symbol::release()
+  {
+    std::atomic<size_t>& refs = entry_->second.refs;
+    size_t count = refs.load(std::memory_order_relaxed);
+    while (count > 1) {
+      if (refs.compare_exchange_weak(count, count - 1,
+        std::memory_order_release, std::memory_order_relaxed)) return;
+    }
+    Shard& entries = shard(entry_->second.hash);
+    std::lock_guard<std::mutex> lock(entries.mutex);
+    if (refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      entries.table.erase(entries.table.find(entry_->first));
+    }
+  }
+
+  size_t Symbol::table_size()
+  {
+    size_t size = 0;
+    for (size_t i = 0; i < SHARDS; ++i) {
+      // any hash selecting the shard
+      Shard& entries = shard(i << 16);
+      std::lock_guard<std::mutex> lock(entries.mutex);
+      size += entries.table.size();
+    }
+    return size;
+  }
+
+}
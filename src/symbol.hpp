@@ -0,0 +1,109 @@
+#ifndef SASS_SYMBOL_H
+#define SASS_SYMBOL_H
+
+// sass.hpp must go before all system headers to get the
+// __EXTENSIONS__ fix on Solaris.
+#include "sass.hpp"
+
+#include <atomic>
+#include <string>
+#include <utility>
+#include <functional>
+
+namespace Sass {
+
+  // Interned string. Equal strings share one entry in a table for
+  // the whole process, so symbols compare by pointer and carry a
+  // precomputed hash. The table is sharded by hash, each shard
+  // taking a lock of its own. Entries count their symbols and are
+  // removed with the last one, so the table only holds the names
+  // in use. The empty string has no entry (copies of it are free).
+  class Symbol {
+
+    public:
+      struct Data {
+        size_t hash;
+        // symbols pointing to the entry
+        std::atomic<size_t> refs;
+        Data(size_t hash) : hash(hash), refs(1) {}
+      };
+      typedef std::pair<const sass::string, Data> Entry;
+
+    private:
+      // points into the table, null for the empty string
+      Entry* entry_;
+
+      Symbol(Entry* entry)
+      : entry_(entry) {}
+
+      void retain() const
+      {
+        if (entry_) entry_->second.refs.fetch_add(1, std::memory_order_relaxed);
+      }
+      // takes the lock of the shard for the last reference
+      void release();
+
+    public:
+      // the empty string
+      Symbol() : entry_(nullptr) {}
+      Symbol(const char* str);
+      Symbol(const sass::string& str);
+      Symbol(const Symbol& symbol) : entry_(symbol.entry_) { retain(); }
+      Symbol(Symbol&& symbol) noexcept : entry_(symbol.entry_) { symbol.entry_ = nullptr; }
+      Symbol& operator=(Symbol symbol) noexcept
+      {
+        std::swap(entry_, symbol.entry_);
+        return *this;
+      }
+      ~Symbol() { if (entry_) release(); }
+
+      // the symbol of the string if it is in use, else the
+      // empty one; no environment holds a name not in use,
+      // so runtime names are looked up without adding them
+      static Symbol find(const sass::string& str);
+
+      // number of entries in the table
+      static size_t table_size();
+
+      bool empty() const { return entry_ == nullptr; }
+
+      const sass::string& str() const;
+      // same as the std::hash of the string
+      size_t hash() const;
+
+      operator const sass::string&() const { return str(); }
+
+      bool operator==(const Symbol& rhs) const { return entry_ == rhs.entry_; }
+      bool operator!=(const Symbol& rhs) const { return entry_ != rhs.entry_; }
+
+      // order of the table, not alphabetical
+      bool operator<(const Symbol& rhs) const { return entry_ < rhs.entry_; }
+
+  };
+
+  inline const sass::string& Symbol::str() const
+  {
+    static const sass::string empty;
+    return entry_ ? entry_->first : empty;
+  }
+
+  inline size_t Symbol::hash() const
+  {
+    static const size_t empty = std::hash<sass::string>()("");
+    return entry_ ? entry_->second.hash : empty;
+  }
+
+}
+
+namespace std {
+  template<>
+  struct hash<Sass::Symbol>
+  {
+    size_t operator()(const Sass::Symbol& symbol) const
+    {
+      return symbol.hash();
+    }
+  };
+}
+
+#endif
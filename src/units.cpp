@@ -1,5 +1,5 @@
 #include "sass.hpp"
-#include <map>
+#include <cstring>
 #include <stdexcept>
 #include <algorithm>
 #include "units.hpp"
@@ -115,6 +115,16 @@ namespace Sass {
     else if (s == "dpi")  return UnitType::DPI;
     else if (s == "dpcm") return UnitType::DPCM;
     else if (s == "dppx") return UnitType::DPPX;
+    // incommensurable units
+    else if (s == "%")    return UnitType::PERCENT;
+    else if (s == "em")   return UnitType::EM;
+    else if (s == "rem")  return UnitType::REM;
+    else if (s == "ex")   return UnitType::EX;
+    else if (s == "ch")   return UnitType::CH;
+    else if (s == "vw")   return UnitType::VW;
+    else if (s == "vh")   return UnitType::VH;
+    else if (s == "vmin") return UnitType::VMIN;
+    else if (s == "vmax") return UnitType::VMAX;
     // for unknown units
     else return UnitType::UNKNOWN;
   }
@@ -144,6 +154,16 @@ namespace Sass {
       case UnitType::DPI:     return "dpi";
       case UnitType::DPCM:    return "dpcm";
       case UnitType::DPPX:    return "dppx";
+      // incommensurable units
+      case UnitType::PERCENT: return "%";
+      case UnitType::EM:      return "em";
+      case UnitType::REM:     return "rem";
+      case UnitType::EX:      return "ex";
+      case UnitType::CH:      return "ch";
+      case UnitType::VW:      return "vw";
+      case UnitType::VH:      return "vh";
+      case UnitType::VMIN:    return "vmin";
+      case UnitType::VMAX:    return "vmax";
       // for unknown units
       default:                return "";
     }
@@ -177,13 +197,13 @@ namespace Sass {
   }
 
   // throws incompatibleUnits exceptions
-  double conversion_factor(const sass::string& s1, const sass::string& s2)
+  double conversion_factor(const Unit& s1, const Unit& s2)
   {
     // assert for same units
     if (s1 == s2) return 1;
-    // get unit enum from string
-    UnitType u1 = string_to_unit(s1);
-    UnitType u2 = string_to_unit(s2);
+    // get unit enum from unit
+    UnitType u1 = s1.type();
+    UnitType u2 = s2.type();
     // query unit group types
     UnitClass t1 = get_unit_type(u1);
     UnitClass t2 = get_unit_type(u2);
@@ -219,7 +239,7 @@ namespace Sass {
     return 0;
   }
 
-  double convert_units(const sass::string& lhs, const sass::string& rhs, int& lhsexp, int& rhsexp)
+  double convert_units(const Unit& lhs, const Unit& rhs, int& lhsexp, int& rhsexp)
   {
     double f = 0;
     // do not convert same ones
@@ -228,15 +248,15 @@ namespace Sass {
     if (lhsexp == 0) return 0;
     if (rhsexp == 0) return 0;
     // check if it can be converted
-    UnitType ulhs = string_to_unit(lhs);
-    UnitType urhs = string_to_unit(rhs);
-    // skip units we cannot convert
-    if (ulhs == UNKNOWN) return 0;
-    if (urhs == UNKNOWN) return 0;
+    UnitType ulhs = lhs.type();
+    UnitType urhs = rhs.type();
     // query unit group types
     UnitClass clhs = get_unit_type(ulhs);
     UnitClass crhs = get_unit_type(urhs);
     // skip units we cannot convert
+    if (clhs == INCOMMENSURABLE) return 0;
+    if (crhs == INCOMMENSURABLE) return 0;
+    // skip units we cannot convert
     if (clhs != crhs) return 0;
     // if right denominator is bigger than lhs, we want to keep it in rhs unit
     if (rhsexp < 0 && lhsexp > 0 && - rhsexp > lhsexp) {
@@ -258,6 +278,98 @@ namespace Sass {
     return f;
   }
 
+  Unit::Unit()
+  : name_(Symbol().str().c_str()), type_(UNKNOWN), symbol_()
+  { }
+
+  Unit::Unit(UnitType type)
+  : name_(unit_to_string(type)), type_(type), symbol_()
+  { }
+
+  Unit::Unit(const sass::string& name)
+  : name_(nullptr), type_(string_to_unit(name)), symbol_()
+  {
+    // custom units are rare, only they need the symbol table
+    if (type_ == UNKNOWN) {
+      symbol_ = name;
+      name_ = symbol_.str().c_str();
+    }
+    else name_ = unit_to_string(type_);
+  }
+
+  size_t Unit::hash() const
+  {
+    if (type_ != UNKNOWN) return std::hash<const char*>()(name_);
+    return symbol_.hash();
+  }
+
+  bool Unit::operator< (const Unit& rhs) const
+  {
+    return name_ != rhs.name_ && std::strcmp(name_, rhs.name_) < 0;
+  }
+
+  UnitList::UnitList(const UnitList& list)
+  : data_(inline_), size_(0), capacity_(INLINE_UNITS)
+  {
+    append(list);
+  }
+
+  UnitList& UnitList::operator= (const UnitList& list)
+  {
+    if (this != &list) {
+      clear();
+      append(list);
+    }
+    return *this;
+  }
+
+  void UnitList::reserve(uint32_t capacity)
+  {
+    if (capacity <= capacity_) return;
+    capacity = std::max(capacity, capacity_ * 2);
+    Unit* data = new Unit[capacity];
+    std::copy(data_, data_ + size_, data);
+    if (data_ != inline_) delete[] data_;
+    data_ = data;
+    capacity_ = capacity;
+  }
+
+  void UnitList::push_back(const Unit& unit)
+  {
+    reserve(size_ + 1);
+    data_[size_ ++] = unit;
+  }
+
+  void UnitList::append(const UnitList& list)
+  {
+    reserve(size_ + list.size_);
+    std::copy(list.data_, list.data_ + list.size_, data_ + size_);
+    size_ += list.size_;
+  }
+
+  void UnitList::erase(Unit* pos)
+  {
+    std::copy(pos + 1, end(), pos);
+    // drops the name of a custom unit
+    data_[-- size_] = Unit();
+  }
+
+  void UnitList::clear()
+  {
+    std::fill(begin(), end(), Unit());
+    size_ = 0;
+  }
+
+  bool UnitList::operator== (const UnitList& rhs) const
+  {
+    return size_ == rhs.size_ && std::equal(begin(), end(), rhs.begin());
+  }
+
+  bool UnitList::operator< (const UnitList& rhs) const
+  {
+    return std::lexicographical_compare(begin(), end(), rhs.begin(), rhs.end());
+  }
+
   bool Units::operator< (const Units& rhs) const
   {
     return (numerators < rhs.numerators) &&
@@ -283,28 +395,26 @@ namespace Sass {
     double factor = 1;
 
     for (size_t i = 0; i < iL; i++) {
-      sass::string &lhs = numerators[i];
-      UnitType ulhs = string_to_unit(lhs);
-      if (ulhs == UNKNOWN) continue;
+      UnitType ulhs = numerators[i].type();
       UnitClass clhs = get_unit_type(ulhs);
+      if (clhs == INCOMMENSURABLE) continue;
       UnitType umain = get_main_unit(clhs);
       if (ulhs == umain) continue;
       double f(conversion_factor(umain, ulhs, clhs, clhs));
       if (f == 0) throw std::runtime_error("INVALID");
-      numerators[i] = unit_to_string(umain);
+      numerators[i] = Unit(umain);
       factor /= f;
     }
 
     for (size_t n = 0; n < nL; n++) {
-      sass::string &rhs = denominators[n];
-      UnitType urhs = string_to_unit(rhs);
-      if (urhs == UNKNOWN) continue;
+      UnitType urhs = denominators[n].type();
       UnitClass crhs = get_unit_type(urhs);
+      if (crhs == INCOMMENSURABLE) continue;
       UnitType umain = get_main_unit(crhs);
       if (urhs == umain) continue;
       double f(conversion_factor(umain, urhs, crhs, crhs));
       if (f == 0) throw std::runtime_error("INVALID");
-      denominators[n] = unit_to_string(umain);
+      denominators[n] = Unit(umain);
       factor /= f;
     }
 
@@ -325,30 +435,42 @@ namespace Sass {
     if (iL + nL < 2) return 1;
 
     // first make sure same units cancel each other out
-    // it seems that a map table will fit nicely to do this
     // we basically construct exponents for each unit
-    // has the advantage that they will be pre-sorted
-    std::map<sass::string, int> exponents;
+    // this will already cancel out equivalent units (e.q. px/px)
+    sass::vector<std::pair<Unit, int>> exponents;
+    auto exponent = [&exponents](const Unit& unit) -> int& {
+      for (auto& exp : exponents) {
+        if (exp.first == unit) return exp.second;
+      }
+      exponents.push_back(std::make_pair(unit, 0));
+      return exponents.back().second;
+    };
 
     // initialize by summing up occurrences in unit vectors
-    // this will already cancel out equivalent units (e.q. px/px)
-    for (size_t i = 0; i < iL; i ++) exponents[numerators[i]] += 1;
-    for (size_t n = 0; n < nL; n ++) exponents[denominators[n]] -= 1;
+    for (size_t i = 0; i < iL; i ++) exponent(numerators[i]) += 1;
+    for (size_t n = 0; n < nL; n ++) exponent(denominators[n]) -= 1;
 
     // the final conversion factor
     double factor = 1;
 
     // convert between compatible units
+    // all units are known, the list no longer grows
     for (size_t i = 0; i < iL; i++) {
       for (size_t n = 0; n < nL; n++) {
-        sass::string &lhs = numerators[i], &rhs = denominators[n];
-        int &lhsexp = exponents[lhs], &rhsexp = exponents[rhs];
+        const Unit &lhs = numerators[i], &rhs = denominators[n];
+        int &lhsexp = exponent(lhs), &rhsexp = exponent(rhs);
         double f(convert_units(lhs, rhs, lhsexp, rhsexp));
         if (f == 0) continue;
         factor /= f;
       }
     }
 
+    // output units in alphabetical order
+    std::sort(exponents.begin(), exponents.end(),
+      [](const std::pair<Unit, int>& lhs, const std::pair<Unit, int>& rhs) {
+        return lhs.first < rhs.first;
+      });
+
     // now we can build up the new unit arrays
     numerators.clear();
     denominators.clear();
@@ -374,12 +496,12 @@ namespace Sass {
     size_t nL = denominators.size();
     for (size_t i = 0; i < iL; i += 1) {
       if (i) u += '*';
-      u += numerators[i];
+      u += numerators[i].name();
     }
     if (nL != 0) u += '/';
     for (size_t n = 0; n < nL; n += 1) {
       if (n) u += '*';
-      u += denominators[n];
+      u += denominators[n].name();
     }
     return u;
   }
@@ -400,11 +522,11 @@ namespace Sass {
   double Units::convert_factor(const Units& r) const
   {
 
-    sass::vector<sass::string> miss_nums(0);
-    sass::vector<sass::string> miss_dens(0);
+    UnitList miss_nums;
+    UnitList miss_dens;
     // create copy since we need these for state keeping
-    sass::vector<sass::string> r_nums(r.numerators);
-    sass::vector<sass::string> r_dens(r.denominators);
+    UnitList r_nums(r.numerators);
+    UnitList r_dens(r.denominators);
 
     auto l_num_it = numerators.begin();
     auto l_num_end = numerators.end();
@@ -419,7 +541,7 @@ namespace Sass {
     while (l_num_it != l_num_end)
     {
       // get and increment afterwards
-      const sass::string l_num = *(l_num_it ++);
+      const Unit l_num = *(l_num_it ++);
 
       auto r_num_it = r_nums.begin(), r_num_end = r_nums.end();
 
@@ -428,7 +550,7 @@ namespace Sass {
       while (r_num_it != r_num_end)
       {
         // get and increment afterwards
-        const sass::string r_num = *(r_num_it);
+        const Unit r_num = *(r_num_it);
         // get possible conversion factor for units
         double conversion = conversion_factor(l_num, r_num);
         // skip incompatible numerator
@@ -456,7 +578,7 @@ namespace Sass {
     while (l_den_it != l_den_end)
     {
       // get and increment afterwards
-      const sass::string l_den = *(l_den_it ++);
+      const Unit l_den = *(l_den_it ++);
 
       auto r_den_it = r_dens.begin();
       auto r_den_end = r_dens.end();
@@ -466,7 +588,7 @@ namespace Sass {
       while (r_den_it != r_den_end)
       {
         // get and increment afterwards
-        const sass::string r_den = *(r_den_it);
+        const Unit r_den = *(r_den_it);
         // get possible conversion factor for units
         double conversion = conversion_factor(l_den, r_den);
         // skip incompatible denominator
@@ -2,10 +2,14 @@
 #define SASS_UNITS_H
 
 #include <cmath>
+#include <cstdint>
+#include <functional>
 #include <string>
 #include <sstream>
 #include <vector>
 
+#include "symbol.hpp"
+
 namespace Sass {
 
   const double PI = std::acos(-1);
@@ -49,14 +53,79 @@ namespace Sass {
     DPPX,
 
     // for unknown units
-    UNKNOWN = INCOMMENSURABLE
+    UNKNOWN = INCOMMENSURABLE,
+
+    // common units we can't convert
+    PERCENT,
+    EM,
+    REM,
+    EX,
+    CH,
+    VW,
+    VH,
+    VMIN,
+    VMAX
+
+  };
 
+  // A single unit. Units with a type are named by a static string,
+  // custom units by the symbol table (the unit keeps the name in it),
+  // so comparing the pointers of their names is enough.
+  class Unit {
+  private:
+    const char* name_;
+    UnitType type_;
+    // name of custom units, empty for the others
+    Symbol symbol_;
+  public:
+    // unknown unit with an empty name, so it can be compared
+    Unit();
+    Unit(UnitType type);
+    Unit(const sass::string& name);
+    const char* name() const { return name_; }
+    UnitType type() const { return type_; }
+    size_t hash() const;
+    bool operator== (const Unit& rhs) const { return name_ == rhs.name_; }
+    bool operator!= (const Unit& rhs) const { return !(*this == rhs); }
+    // alphabetical order of the names
+    bool operator< (const Unit& rhs) const;
+  };
+
+  // List of units stored inline up to a small size, so copying
+  // numbers with a single unit (the usual case) doesn't allocate.
+  class UnitList {
+  private:
+    static const uint32_t INLINE_UNITS = 1;
+    Unit inline_[INLINE_UNITS];
+    Unit* data_;
+    uint32_t size_;
+    uint32_t capacity_;
+    void reserve(uint32_t capacity);
+  public:
+    UnitList() : data_(inline_), size_(0), capacity_(INLINE_UNITS) { }
+    UnitList(const UnitList& list);
+    UnitList& operator= (const UnitList& list);
+    ~UnitList() { if (data_ != inline_) delete[] data_; }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    void clear();
+    Unit* begin() { return data_; }
+    Unit* end() { return data_ + size_; }
+    const Unit* begin() const { return data_; }
+    const Unit* end() const { return data_ + size_; }
+    Unit& operator[] (size_t i) { return data_[i]; }
+    const Unit& operator[] (size_t i) const { return data_[i]; }
+    void push_back(const Unit& unit);
+    void append(const UnitList& list);
+    void erase(Unit* pos);
+    bool operator== (const UnitList& rhs) const;
+    bool operator< (const UnitList& rhs) const;
   };
 
   class Units {
   public:
-    sass::vector<sass::string> numerators;
-    sass::vector<sass::string> denominators;
+    UnitList numerators;
+    UnitList denominators;
   public:
     // default constructor
     Units() :
@@ -101,9 +170,9 @@ namespace Sass {
   sass::string get_unit_class(Sass::UnitType unit);
   sass::string unit_to_class(const sass::string&);
   // throws incompatibleUnits exceptions
-  double conversion_factor(const sass::string&, const sass::string&);
+  double conversion_factor(const Unit&, const Unit&);
   double conversion_factor(UnitType, UnitType, UnitClass, UnitClass);
-  double convert_units(const sass::string&, const sass::string&, int&, int&);
+  double convert_units(const Unit&, const Unit&, int&, int&);
 
 }
 
@@ -9,10 +9,15 @@
 #include "utf8/checked.h"
 
 #include <cmath>
+#include <clocale>
+#include <cstdlib>
 #include <stdint.h>
 #if defined(_MSC_VER) && _MSC_VER >= 1800 && _MSC_VER < 1900 && defined(_M_X64)
 #include <mutex>
 #endif
+#ifdef __APPLE__
+#include <xlocale.h>
+#endif
 
 namespace Sass {
 
@@ -35,27 +40,30 @@ namespace Sass {
     return ::round(val);
   }
 
+  // The C locale, so numbers parse the same whatever locale the host
+  // has set (now or later). Created once and never freed.
+  #ifdef _WIN32
+  static _locale_t c_locale()
+  {
+    static _locale_t locale = _create_locale(LC_NUMERIC, "C");
+    return locale;
+  }
+  #else
+  static locale_t c_locale()
+  {
+    static locale_t locale = newlocale(LC_NUMERIC_MASK, "C", (locale_t) 0);
+    return locale;
+  }
+  #endif
+
   /* Locale unspecific atof function. */
   double sass_strtod(const char *str)
   {
-    char separator = *(localeconv()->decimal_point);
-    if(separator != '.'){
-      // The current locale specifies another
-      // separator. convert the separator to the
-      // one understood by the locale if needed
-      const char *found = strchr(str, '.');
-      if(found != NULL){
-        // substitution is required. perform the substitution on a copy
-        // of the string. This is slower but it is thread safe.
-        char *copy = sass_copy_c_string(str);
-        *(copy + (found - str)) = separator;
-        double res = strtod(copy, NULL);
-        free(copy);
-        return res;
-      }
-    }
-
-    return strtod(str, NULL);
+    #ifdef _WIN32
+    return _strtod_l(str, NULL, c_locale());
+    #else
+    return strtod_l(str, NULL, c_locale());
+    #endif
   }
 
   // helper for safe access to c_ctx
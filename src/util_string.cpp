@@ -2,6 +2,11 @@
 
 #include <iostream>
 #include <algorithm>
+#include <cstring>
+#include <cstdint>
+#include <cmath>
+#include <locale>
+#include <sstream>
 
 namespace Sass {
   namespace Util {
@@ -118,6 +123,111 @@ namespace Sass {
       }
     }
 
+    sass::string format_fixed(double value, int precision) {
+      // leave the rare ones to a stream, it knows how to print
+      // nan, inf and the exact digits of very large numbers
+      if (!(std::fabs(value) < 18446744073709551616.0) || precision < 0) {
+        sass::sstream ss;
+        ss.imbue(std::locale::classic());
+        ss.precision(precision);
+        ss << std::fixed << value;
+        return ss.str();
+      }
+
+      // split into value = mantissa * 2^exponent
+      uint64_t bits;
+      std::memcpy(&bits, &value, sizeof(bits));
+      bool negative = (bits >> 63) != 0;
+      int exponent = static_cast<int>((bits >> 52) & 0x7FF);
+      uint64_t mantissa = bits & ((uint64_t(1) << 52) - 1);
+      if (exponent == 0) exponent = 1;
+      else mantissa |= uint64_t(1) << 52;
+      exponent -= 1075;
+
+      // the integer part fits into 64 bits, the fraction
+      // is kept exactly as 32 bit words (most significant
+      // last), so we can multiply it by ten for each digit
+      uint64_t integer = mantissa;
+      uint32_t fraction[35];
+      size_t words = 0;
+      if (exponent >= 0) {
+        integer = mantissa << exponent;
+      }
+      else {
+        size_t shift = static_cast<size_t>(-exponent);
+        uint64_t rest = mantissa;
+        if (shift < 64) {
+          integer = mantissa >> shift;
+          rest = mantissa & ((uint64_t(1) << shift) - 1);
+        }
+        else {
+          integer = 0;
+        }
+        words = (shift + 31) / 32;
+        // offset of the fraction within the words
+        int offset = static_cast<int>(words * 32 - shift);
+        for (size_t i = 0; i < words; ++i) {
+          int pos = static_cast<int>(i * 32) - offset;
+          uint64_t part = pos < 0 ? rest << -pos
+            : pos < 64 ? rest >> pos : 0;
+          fraction[i] = static_cast<uint32_t>(part);
+        }
+      }
+
+      sass::string result;
+      if (negative) result += '-';
+      char digits[20];
+      size_t length = 0;
+      do {
+        digits[length++] = static_cast<char>('0' + integer % 10);
+        integer /= 10;
+      } while (integer != 0);
+      while (length != 0) result += digits[--length];
+      size_t last = result.size() - 1;
+
+      if (precision > 0) {
+        result += '.';
+        for (int i = 0; i < precision; ++i) {
+          uint64_t carry = 0;
+          for (size_t n = 0; n < words; ++n) {
+            uint64_t product = uint64_t(fraction[n]) * 10 + carry;
+            fraction[n] = static_cast<uint32_t>(product);
+            carry = product >> 32;
+          }
+          result += static_cast<char>('0' + carry);
+        }
+        last = result.size() - 1;
+      }
+
+      // round the remaining fraction, ties to even
+      bool round_up = false;
+      if (words != 0) {
+        uint32_t top = fraction[words - 1];
+        if (top > 0x80000000u) round_up = true;
+        else if (top == 0x80000000u) {
+          bool above = false;
+          for (size_t n = 0; n + 1 < words; ++n) {
+            if (fraction[n] != 0) { above = true; break; }
+          }
+          round_up = above || (result[last] - '0') % 2 == 1;
+        }
+      }
+      if (round_up) {
+        size_t pos = last + 1;
+        while (pos-- > 0) {
+          if (result[pos] == '.') continue;
+          if (result[pos] == '-') { pos = 0; break; }
+          if (result[pos] != '9') { ++result[pos]; return result; }
+          result[pos] = '0';
+          if (pos == 0) break;
+        }
+        // carried over the first digit
+        result.insert(negative ? 1 : 0, 1, '1');
+      }
+
+      return result;
+    }
+
   }
   // namespace Util
 
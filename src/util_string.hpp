@@ -30,6 +30,14 @@ namespace Sass {
     char opening_bracket_for(char closing_bracket);
     char closing_bracket_for(char opening_bracket);
 
+    // ##########################################################################
+    // Formats [value] with [precision] digits after the decimal point, like a
+    // stream with `std::fixed` (correctly rounded, ties to even), but without
+    // a stream and independent of the locale. Short results fit into the
+    // small string buffer, so most numbers are formatted without allocating.
+    // ##########################################################################
+    sass::string format_fixed(double value, int precision);
+
     // Locale-independent ASCII character routines.
 
     inline bool ascii_isalpha(unsigned char c) {
@@ -0,0 +1,90 @@
+#include "../src/sass.hpp"
+#include "../src/ast.hpp"
+
+#include <chrono>
+#include <cstdio>
+
+// Times `Cast` on a mix of values, as done for every operand in the
+// eval loop, against the former `typeid` and `dynamic_cast` checks.
+// Built against the optimized library (not run with the tests).
+
+using namespace Sass;
+
+namespace {
+
+  const size_t NODES = 1024;
+  const size_t ROUNDS = 20000;
+
+  // the former implementation for final classes
+  template<class T>
+  T* typeid_cast(AST_Node* ptr) {
+    return ptr && typeid(T) == typeid(*ptr) ?
+           static_cast<T*>(ptr) : NULL;
+  }
+
+  struct ByKind {
+    template<class T>
+    static T* cast(AST_Node* ptr) { return Cast<T>(ptr); }
+  };
+
+  struct ByRtti {
+    template<class T>
+    static T* cast(AST_Node* ptr) { return typeid_cast<T>(ptr); }
+  };
+
+  // only here for the base classes, as before
+  template<> Value* ByRtti::cast(AST_Node* ptr) { return dynamic_cast<Value*>(ptr); }
+  template<> Color* ByRtti::cast(AST_Node* ptr) { return dynamic_cast<Color*>(ptr); }
+  template<> String_Constant* ByRtti::cast(AST_Node* ptr) { return dynamic_cast<String_Constant*>(ptr); }
+
+  // same dispatch as `Eval::operator()(Binary_Expression*)`
+  template<class C>
+  size_t dispatch(const sass::vector<ExpressionObj>& nodes) {
+    size_t hits = 0;
+    for (size_t r = 0; r < ROUNDS; ++r) {
+      for (const ExpressionObj& node : nodes) {
+        AST_Node* ptr = node.ptr();
+        if (C::template cast<Value>(ptr) == nullptr) continue;
+        if (C::template cast<Number>(ptr)) hits += 1;
+        else if (C::template cast<Color>(ptr)) hits += 2;
+        else if (C::template cast<String_Constant>(ptr)) hits += 3;
+        else if (C::template cast<Null>(ptr)) hits += 4;
+        else if (C::template cast<List>(ptr)) hits += 5;
+      }
+    }
+    return hits;
+  }
+
+  template<class C>
+  double measure(const char* name, const sass::vector<ExpressionObj>& nodes, size_t& hits) {
+    auto start = std::chrono::steady_clock::now();
+    hits = dispatch<C>(nodes);
+    auto stop = std::chrono::steady_clock::now();
+    double ns = std::chrono::duration<double, std::nano>(stop - start).count();
+    ns /= double(NODES * ROUNDS);
+    std::printf("%-12s %6.2f ns per node\n", name, ns);
+    return ns;
+  }
+
+}
+
+int main() {
+  SourceSpan pstate("[bench]");
+  sass::vector<ExpressionObj> nodes;
+  for (size_t i = 0; i < NODES; ++i) {
+    switch (i % 8) {
+      case 0: case 1: case 2:
+        nodes.push_back(SASS_MEMORY_NEW(Number, pstate, double(i), "px")); break;
+      case 3: nodes.push_back(SASS_MEMORY_NEW(Color_RGBA, pstate, 1, 2, 3)); break;
+      case 4: nodes.push_back(SASS_MEMORY_NEW(String_Quoted, pstate, "a", '"')); break;
+      case 5: nodes.push_back(SASS_MEMORY_NEW(String_Constant, pstate, "b")); break;
+      case 6: nodes.push_back(SASS_MEMORY_NEW(Null, pstate)); break;
+      case 7: nodes.push_back(SASS_MEMORY_NEW(List, pstate)); break;
+    }
+  }
+  size_t by_kind = 0, by_rtti = 0;
+  double rtti = measure<ByRtti>("typeid", nodes, by_rtti);
+  double kind = measure<ByKind>("node kind", nodes, by_kind);
+  std::printf("speedup      %6.2fx\n", rtti / kind);
+  return by_kind == by_rtti ? 0 : 1;
+}
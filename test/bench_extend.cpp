@@ -0,0 +1,84 @@
+#include "sass/context.h"
+#include "../src/sass.hpp"
+#include "../src/context.hpp"
+#include "../src/sass_context.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Times stylesheets whose @extend rules come after the style rules they
+// extend, so every extension goes through `extendExistingStyleRules`.
+// The rules are spread over several media contexts. Prints the median of
+// a few runs to make results comparable between builds, followed by the
+// hit rates of the extender caches. Built against the optimized library
+// (not run with the tests).
+
+namespace {
+
+  const int RULES = 10000;
+  const int MEDIA = 8;
+  const int EXTENDS = 200;
+  const int RUNS = 5;
+
+  std::string stylesheet() {
+    std::string css;
+    for (int m = 0; m < MEDIA; ++m) {
+      css += "@media (min-width: " + std::to_string(m * 100) + "px) {\n";
+      for (int i = m; i < RULES; i += MEDIA) {
+        std::string n(std::to_string(i % EXTENDS));
+        css += "  .a-" + n + " .b-" + std::to_string(i) + ", .c-" + n + ":hover"
+               " { width: " + std::to_string(i) + "px; }\n";
+      }
+      for (int e = m; e < EXTENDS; e += MEDIA) {
+        std::string n(std::to_string(e));
+        css += "  .x-" + n + " { @extend .a-" + n + "; }\n"
+               "  .y-" + n + " { @extend .c-" + n + "; }\n";
+      }
+      css += "}\n";
+    }
+    return css;
+  }
+
+  double compile(const std::string& source) {
+    struct Sass_Data_Context* data_ctx =
+      sass_make_data_context(sass_copy_c_string(source.c_str()));
+    struct Sass_Context* ctx = sass_data_context_get_context(data_ctx);
+    auto start = std::chrono::steady_clock::now();
+    int status = sass_compile_data_context(data_ctx);
+    auto stop = std::chrono::steady_clock::now();
+    if (status != 0) std::fprintf(stderr, "%s", sass_context_get_error_message(ctx));
+    sass_delete_data_context(data_ctx);
+    return std::chrono::duration<double, std::milli>(stop - start).count();
+  }
+
+  // the c api doesn't expose the extender
+  std::string cache_report(const std::string& source) {
+    struct Sass_Data_Context* data_ctx =
+      sass_make_data_context(sass_copy_c_string(source.c_str()));
+    std::string report;
+    {
+      Sass::Data_Context cpp_ctx(*data_ctx);
+      Sass::Memory::ArenaScope scope(cpp_ctx.arena);
+      cpp_ctx.parse();
+      cpp_ctx.compile();
+      report = cpp_ctx.extender.cacheReport();
+    }
+    sass_delete_data_context(data_ctx);
+    return report;
+  }
+
+}
+
+int main() {
+  std::string source(stylesheet());
+  std::vector<double> times;
+  for (int r = 0; r < RUNS; ++r) times.push_back(compile(source));
+  std::sort(times.begin(), times.end());
+  std::printf("extend     %8.1f ms (median of %d, min %.1f, max %.1f)\n",
+              times[RUNS / 2], RUNS, times.front(), times.back());
+  std::printf("%s", cache_report(source).c_str());
+  return 0;
+}
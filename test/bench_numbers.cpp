@@ -0,0 +1,90 @@
+#include "../src/sass.hpp"
+#include "../src/util_string.hpp"
+#include "sass/context.h"
+
+#include <chrono>
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Times number formatting, as done for every number in the output,
+// against the former stream based formatting, and compiles a stylesheet
+// full of numbers and colors. Built against the optimized library (not
+// run with the tests).
+
+namespace {
+
+  const size_t VALUES = 4096;
+  const size_t ROUNDS = 200;
+  const int PRECISION = 10;
+
+  // the former implementation
+  std::string stream_fixed(double value, int precision) {
+    std::stringstream ss;
+    ss.precision(precision);
+    ss << std::fixed << value;
+    return ss.str();
+  }
+
+  struct ByStream {
+    static std::string format(double value) { return stream_fixed(value, PRECISION); }
+  };
+
+  struct ByFormatter {
+    static std::string format(double value) { return Sass::Util::format_fixed(value, PRECISION); }
+  };
+
+  template<class F>
+  double measure(const char* name, const std::vector<double>& values, size_t& chars) {
+    auto start = std::chrono::steady_clock::now();
+    for (size_t r = 0; r < ROUNDS; ++r) {
+      for (double value : values) chars += F::format(value).size();
+    }
+    auto stop = std::chrono::steady_clock::now();
+    double ms = std::chrono::duration<double, std::milli>(stop - start).count();
+    std::printf("%-10s %8.1f ms\n", name, ms);
+    return ms;
+  }
+
+  double compile(const std::string& source, Sass_Output_Style style) {
+    struct Sass_Data_Context* data_ctx =
+      sass_make_data_context(sass_copy_c_string(source.c_str()));
+    struct Sass_Context* ctx = sass_data_context_get_context(data_ctx);
+    sass_option_set_output_style(sass_context_get_options(ctx), style);
+    auto start = std::chrono::steady_clock::now();
+    int status = sass_compile_data_context(data_ctx);
+    auto stop = std::chrono::steady_clock::now();
+    if (status != 0) std::fprintf(stderr, "%s", sass_context_get_error_message(ctx));
+    sass_delete_data_context(data_ctx);
+    return std::chrono::duration<double, std::milli>(stop - start).count();
+  }
+
+}
+
+int main() {
+  // the kind of values found in stylesheets
+  std::vector<double> values;
+  for (size_t i = 0; i < VALUES; ++i) {
+    switch (i % 4) {
+      case 0: values.push_back(static_cast<double>(i % 97)); break;
+      case 1: values.push_back((i % 1000) / 8.0); break;
+      case 2: values.push_back(1.0 / (i + 3)); break;
+      default: values.push_back(-(i * 0.37)); break;
+    }
+  }
+  size_t stream_chars = 0, formatter_chars = 0;
+  measure<ByStream>("stream", values, stream_chars);
+  measure<ByFormatter>("formatter", values, formatter_chars);
+  if (stream_chars != formatter_chars) std::fprintf(stderr, "results differ\n");
+
+  std::string source;
+  for (size_t i = 0; i < 20000; ++i) {
+    std::string n = std::to_string(i);
+    source += ".n" + n + " { width: (" + n + "px / 3); margin: -" + n + " * 0.25em; "
+      "opacity: (" + n + " / 20000); color: rgb(" + std::to_string(i % 256) + ", 17, 34); }\n";
+  }
+  std::printf("%-10s %8.1f ms\n", "expanded", compile(source, SASS_STYLE_EXPANDED));
+  std::printf("%-10s %8.1f ms\n", "compressed", compile(source, SASS_STYLE_COMPRESSED));
+  return 0;
+}
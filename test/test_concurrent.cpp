@@ -0,0 +1,125 @@
+#include "sass/context.h"
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Compiles many stylesheets concurrently and checks that every
+// result matches the result of the same sequential compilation.
+// Also runs the same stylesheets through `sass_compile_batch`
+// with the stylesheet cache (shared by all threads) enabled.
+// Meant to be built and run with `-fsanitize=thread`.
+
+namespace {
+
+  const size_t THREADS = 8;
+  const size_t ITERATIONS = 25;
+
+  std::string stylesheet(size_t n) {
+    std::ostringstream css;
+    css << "$n: " << n << ";\n"
+        << "$map: (a: 1px, b: 2em, c: red);\n"
+        << "@function scale($v) { @return $v * 1.5 + $n; }\n"
+        << "@mixin box($w) { width: $w; height: $w / 2; }\n"
+        << "%base { color: rgba(#abcdef, 0.5); }\n"
+        << ".rand { a: type-of(random()); b: str-length(unique-id()); }\n";
+    for (size_t i = 0; i < 20; i++) {
+      css << ".item-" << i << " { @extend %base; @include box(" << i << "px);"
+          << " margin: scale(" << i << "); c: mix(red, blue, " << (i * 5) << "%);"
+          << " d: map-get($map, " << "abc"[i % 3] << "); e: darken(aliceblue, " << i << "%);"
+          << " &:hover .nested { f: percentage(" << i << " / 20); } }\n"
+          << "@media (min-width: " << (i * 100) << "px) { .item-" << i << " { g: h; } }\n";
+    }
+    css << ".sel { a: selector-unify('.a', '.b'); b: nth(join(1 2, 3 4), 3); }\n";
+    return css.str();
+  }
+
+  bool compile(const std::string& source, std::string& output) {
+    struct Sass_Data_Context* data_ctx =
+      sass_make_data_context(sass_copy_c_string(source.c_str()));
+    struct Sass_Context* ctx = sass_data_context_get_context(data_ctx);
+    struct Sass_Options* options = sass_context_get_options(ctx);
+    sass_option_set_output_style(options, SASS_STYLE_COMPRESSED);
+    bool ok = sass_compile_data_context(data_ctx) == 0;
+    if (ok) output = sass_context_get_output_string(ctx);
+    else output = sass_context_get_error_message(ctx);
+    sass_delete_data_context(data_ctx);
+    return ok;
+  }
+
+  // compiles all stylesheets from files in one batch
+  size_t compile_batch(const std::vector<std::string>& sources,
+                       const std::vector<std::string>& expected) {
+    std::vector<std::string> paths;
+    std::vector<struct Sass_File_Context*> ctxs;
+    for (size_t i = 0; i < sources.size() * ITERATIONS; i++) {
+      if (i < sources.size()) {
+        paths.push_back("build/batch-" + std::to_string(i) + ".scss");
+        std::ofstream(paths.back()) << sources[i];
+      }
+      ctxs.push_back(sass_make_file_context(paths[i % sources.size()].c_str()));
+      struct Sass_Options* options = sass_file_context_get_options(ctxs.back());
+      sass_option_set_output_style(options, SASS_STYLE_COMPRESSED);
+      sass_option_set_stylesheet_cache(options, true);
+    }
+    size_t failed = sass_compile_batch(ctxs.data(), ctxs.size(), THREADS);
+    for (size_t i = 0; i < ctxs.size(); i++) {
+      struct Sass_Context* ctx = sass_file_context_get_context(ctxs[i]);
+      const char* output = sass_context_get_output_string(ctx);
+      if (!output || expected[i % sources.size()] != output) {
+        std::cerr << "Failed: batch entry " << i << std::endl;
+        ++failed;
+      }
+      sass_delete_file_context(ctxs[i]);
+    }
+    for (const std::string& path : paths) std::remove(path.c_str());
+    return failed;
+  }
+
+}
+
+int main(int argc, char **argv) {
+  std::vector<std::string> sources;
+  std::vector<std::string> expected;
+  for (size_t i = 0; i < THREADS; i++) {
+    std::string output;
+    sources.push_back(stylesheet(i));
+    if (!compile(sources.back(), output)) {
+      std::cerr << "Failed to compile: " << output << std::endl;
+      return 1;
+    }
+    expected.push_back(output);
+  }
+
+  std::atomic<size_t> passed(0);
+  std::atomic<size_t> failed(0);
+  std::vector<std::thread> workers;
+  for (size_t t = 0; t < THREADS; t++) {
+    workers.emplace_back([&, t]() {
+      for (size_t i = 0; i < ITERATIONS; i++) {
+        // every thread cycles through all stylesheets
+        size_t n = (t + i) % THREADS;
+        std::string output;
+        if (compile(sources[n], output) && output == expected[n]) {
+          ++passed;
+        } else {
+          std::cerr << "Failed: stylesheet " << n << " on thread " << t << std::endl;
+          ++failed;
+        }
+      }
+    });
+  }
+  for (std::thread& worker : workers) worker.join();
+  failed += compile_batch(sources, expected);
+
+  std::cerr << argv[0] << ": Passed: " << passed
+            << ", failed: " << failed
+            << "." << std::endl;
+  return failed != 0;
+}
@@ -0,0 +1,132 @@
+#include "sass/context.h"
+#include "test_macros.hpp"
+
+#include <cstring>
+#include <iostream>
+#include <set>
+#include <string>
+#include <vector>
+
+// Checks that selectors built by @extend map to the rule they extend, also
+// when the extender reuses a unification it computed for an equal selector
+// of an earlier rule.
+
+namespace {
+
+  // A mapping of the generated css back to the source (zero based)
+  struct Segment {
+    size_t line;
+    size_t column;
+    long source_line;
+  };
+
+  int base64(char c) {
+    const char* digits = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    const char* found = std::strchr(digits, c);
+    return found && c ? int(found - digits) : -1;
+  }
+
+  // Decodes the vlq fields of one segment, starting at `pos`
+  std::vector<long> fields(const std::string& mappings, size_t& pos) {
+    std::vector<long> values;
+    long value = 0;
+    int shift = 0;
+    while (pos < mappings.size() && mappings[pos] != ',' && mappings[pos] != ';') {
+      int digit = base64(mappings[pos++]);
+      value += long(digit & 31) << shift;
+      shift += 5;
+      if (digit & 32) continue;
+      values.push_back(value & 1 ? -(value >> 1) : value >> 1);
+      value = 0;
+      shift = 0;
+    }
+    return values;
+  }
+
+  std::vector<Segment> decode(const std::string& map) {
+    std::vector<Segment> segments;
+    size_t start = map.find("\"mappings\": \"") + std::strlen("\"mappings\": \"");
+    std::string mappings(map.substr(start, map.find('"', start) - start));
+    size_t line = 0, column = 0;
+    long source_line = 0;
+    for (size_t pos = 0; pos < mappings.size(); ) {
+      if (mappings[pos] == ';') { line += 1; column = 0; pos += 1; continue; }
+      if (mappings[pos] == ',') { pos += 1; continue; }
+      std::vector<long> values(fields(mappings, pos));
+      column += values[0];
+      if (values.size() >= 4) {
+        source_line += values[2];
+        segments.push_back({ line, column, source_line });
+      }
+    }
+    return segments;
+  }
+
+  std::vector<std::string> lines(const std::string& css) {
+    std::vector<std::string> result(1);
+    for (char c : css) {
+      if (c == '\n') result.push_back("");
+      else result.back() += c;
+    }
+    return result;
+  }
+
+  // The same compound `.a.b` in two rules, the second one spread over
+  // two lines, so the extended selectors differ in their source lines
+  const char* SOURCE =
+    ".x .a.b { a: b }\n"
+    "\n"
+    ".y\n"
+    "  .a.b { a: b }\n"
+    ".q .c { @extend .a; }\n";
+
+  bool compile(std::string& css, std::string& map) {
+    struct Sass_Data_Context* data_ctx = sass_make_data_context(sass_copy_c_string(SOURCE));
+    struct Sass_Context* ctx = sass_data_context_get_context(data_ctx);
+    struct Sass_Options* options = sass_data_context_get_options(data_ctx);
+    sass_option_set_output_style(options, SASS_STYLE_EXPANDED);
+    sass_option_set_source_map_file(options, "out.css.map");
+    bool compiled = sass_compile_data_context(data_ctx) == 0;
+    if (compiled) {
+      css = sass_context_get_output_string(ctx);
+      map = sass_context_get_source_map_string(ctx);
+    }
+    else {
+      std::cerr << sass_context_get_error_message(ctx);
+    }
+    sass_delete_data_context(data_ctx);
+    return compiled;
+  }
+
+}
+
+bool TestRepeatedSelectors() {
+  std::string css, map;
+  ASSERT(compile(css, map));
+  std::vector<std::string> generated(lines(css));
+  size_t second_rule = 0;
+  while (second_rule < generated.size() && generated[second_rule] != ".y") {
+    second_rule += 1;
+  }
+  ASSERT(second_rule < generated.size());
+  std::set<std::pair<size_t, size_t>> checked;
+  for (const Segment& segment : decode(map)) {
+    const std::string& line = generated[segment.line];
+    if (line.compare(segment.column, 2, ".b") != 0) continue;
+    ASSERT(segment.source_line == (segment.line < second_rule ? 0 : 3));
+    checked.insert({ segment.line, segment.column });
+  }
+  // `.b` of the rules and of the two selectors extending each
+  ASSERT(checked.size() == 6);
+  return true;
+}
+
+int main(int argc, char **argv) {
+  std::vector<std::string> passed;
+  std::vector<std::string> failed;
+  TEST(TestRepeatedSelectors);
+  std::cerr << argv[0] << ": Passed: " << passed.size()
+            << ", failed: " << failed.size()
+            << "." << std::endl;
+  return failed.size();
+}
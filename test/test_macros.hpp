@@ -0,0 +1,22 @@
+#ifndef SASS_TEST_MACROS_H
+#define SASS_TEST_MACROS_H
+
+#include <iostream>
+
+// Assertions of the test functions, which return false on failure
+#define ASSERT(cond) \
+  if (!(cond)) { \
+    std::cerr << "Assertion failed: " #cond " at " __FILE__ << ":" << __LINE__ << std::endl; \
+    return false; \
+  } \
+
+// Runs a test function, needs the `passed` and `failed` vectors of main
+#define TEST(fn) \
+  if (fn()) { \
+    passed.push_back(#fn); \
+  } else { \
+    failed.push_back(#fn); \
+    std::cerr << "Failed: " #fn << std::endl; \
+  } \
+
+#endif
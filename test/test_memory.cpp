@@ -0,0 +1,197 @@
+#include "sass/context.h"
+#include "../src/sass.hpp"
+#include "../src/symbol.hpp"
+#include "test_macros.hpp"
+
+#include <sys/resource.h>
+#include <malloc.h>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Checks the peak memory of loop heavy compilations. Interpolated selectors
+// and media queries are parsed again on every iteration, neither the texts
+// nor the parsed nodes may be kept beyond their use. Budgets are relative to
+// a plain stylesheet of the same shape measured in the same process, so they
+// do not depend on the machine. Names only known at runtime must not be
+// kept either, nor the names of compiled stylesheets.
+
+namespace {
+
+  const int ITERATIONS = 10000;
+
+  // peak of the interpolated stylesheet relative to the plain one
+  // (measured 1.4, keeping all parsed interpolations gave 2.0)
+  const double BUDGET_RATIO = 1.75;
+
+  // allowed growth of the peak over later compilations
+  const double SLACK_RATIO = 0.05;
+
+  long peak_rss_kb() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    #ifdef __APPLE__
+      return usage.ru_maxrss / 1024;
+    #else
+      return usage.ru_maxrss;
+    #endif
+  }
+
+  // bytes in use on the heap, -1 if unknown
+  long heap_bytes() {
+    #if defined(__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 33)
+      return static_cast<long>(mallinfo2().uordblks);
+    #else
+      return -1;
+    #endif
+  }
+
+  std::string stylesheet(bool interpolated = true) {
+    std::string loop = "@for $i from 1 through " + std::to_string(ITERATIONS) + " { @include m($i); }\n";
+    if (!interpolated) return
+      "@mixin m($i) {\n"
+      "  %p-x .b-x, .c-x { color: red; }\n"
+      "  @media screen and (min-width: 1px) { %q-x { width: $i; } }\n"
+      "}\n" + loop;
+    return
+      "@mixin m($i) {\n"
+      "  %p-#{$i} .b-#{$i % 10}, .c-#{$i} { color: red; }\n"
+      "  @media #{\"screen and (min-width: \" + $i + \"px)\"} { %q-#{$i} { width: $i; } }\n"
+      "}\n" + loop;
+  }
+
+  // returns a number with a new custom unit on every call
+  union Sass_Value* custom_unit(const union Sass_Value* args, Sass_Function_Entry cb, struct Sass_Compiler* comp) {
+    static unsigned long counter = 0;
+    return sass_make_number(1, ("u" + std::to_string(++counter)).c_str());
+  }
+
+  // returns its argument with a custom unit
+  union Sass_Value* zork(const union Sass_Value* args, Sass_Function_Entry cb, struct Sass_Compiler* comp) {
+    return sass_make_number(sass_number_get_value(sass_list_get_value(args, 0)), "zork");
+  }
+
+  // names only known at runtime, different for each round
+  std::string lookups(int round) {
+    std::string suffix(std::to_string(round));
+    return
+      "@for $i from 1 through " + std::to_string(ITERATIONS) + " {\n"
+      "  $a: variable-exists(v-#{$i}-" + suffix + ") function-exists(f-#{$i}-" + suffix + ");\n"
+      "  $b: mixin-exists(m-#{$i}-" + suffix + ") custom-unit();\n"
+      "}\n";
+  }
+
+  // names of the stylesheet, different for each round
+  std::string names(int round) {
+    std::string suffix(std::to_string(round));
+    return
+      "$v-" + suffix + ": 1u-" + suffix + ";\n"
+      "@function f-" + suffix + "($p-" + suffix + ") { @return $p-" + suffix + "; }\n"
+      "@mixin m-" + suffix + " { a: f-" + suffix + "($v-" + suffix + ") zork(1); }\n"
+      "b { @include m-" + suffix + "; }\n";
+  }
+
+  bool compile(const std::string& source, bool functions = false, std::string* output = nullptr) {
+    struct Sass_Data_Context* data_ctx =
+      sass_make_data_context(sass_copy_c_string(source.c_str()));
+    struct Sass_Context* ctx = sass_data_context_get_context(data_ctx);
+    if (functions) {
+      Sass_Function_List list = sass_make_function_list(2);
+      sass_function_set_list_entry(list, 0, sass_make_function("custom-unit()", custom_unit, 0));
+      sass_function_set_list_entry(list, 1, sass_make_function("zork($x)", zork, 0));
+      sass_option_set_c_functions(sass_data_context_get_options(data_ctx), list);
+    }
+    sass_option_set_output_style(sass_data_context_get_options(data_ctx), SASS_STYLE_COMPRESSED);
+    int status = sass_compile_data_context(data_ctx);
+    if (status != 0) std::cerr << sass_context_get_error_message(ctx);
+    else if (output) *output = sass_context_get_output_string(ctx);
+    sass_delete_data_context(data_ctx);
+    return status == 0;
+  }
+
+}
+
+// must run first, the peak only grows
+bool TestPeakOfLoops() {
+  long base = peak_rss_kb();
+  ASSERT(compile(stylesheet(false)));
+  long plain = peak_rss_kb() - base;
+  ASSERT(compile(stylesheet()));
+  long interpolated = peak_rss_kb() - base;
+  std::printf("plain: %ld KB, interpolated: %ld KB\n", plain, interpolated);
+  ASSERT(interpolated < plain * BUDGET_RATIO);
+  return true;
+}
+
+bool TestNoGrowthOverCompilations() {
+  std::string source(stylesheet());
+  ASSERT(compile(source));
+  long first = peak_rss_kb();
+  for (int i = 0; i < 3; ++i) ASSERT(compile(source));
+  long last = peak_rss_kb();
+  std::printf("later compilations: %ld KB\n", last - first);
+  ASSERT(last - first <= first * SLACK_RATIO);
+  return true;
+}
+
+// runtime names must not stay in the symbol table (the peak
+// doesn't show it, the memory is freed by the compilations)
+bool TestNoGrowthOfRuntimeNames() {
+  ASSERT(compile(lookups(0), true));
+  long first = heap_bytes();
+  for (int i = 1; i < 4; ++i) ASSERT(compile(lookups(i), true));
+  long last = heap_bytes();
+  if (first < 0) return true;
+  std::printf("heap after later lookups: %ld KB\n", (last - first) / 1024);
+  // keeping them takes 100 bytes or more per name
+  ASSERT(last - first < ITERATIONS * 10);
+  return true;
+}
+
+// the symbol table only holds the names in use
+bool TestNoGrowthOfSymbolTable() {
+  ASSERT(compile(names(0), true));
+  size_t first = Sass::Symbol::table_size();
+  for (int i = 1; i < 4; ++i) ASSERT(compile(names(i), true));
+  ASSERT(Sass::Symbol::table_size() == first);
+  // and drops them once they are not
+  {
+    Sass::Symbol name("$not-in-use");
+    ASSERT(Sass::Symbol::table_size() == first + 1);
+    ASSERT(Sass::Symbol::find("$not-in-use") == name);
+  }
+  ASSERT(Sass::Symbol::table_size() == first);
+  ASSERT(Sass::Symbol::find("$not-in-use").empty());
+  return true;
+}
+
+// custom units of functions are interned, they must
+// still equal the same units of numbers created from them
+bool TestUnitsOfCustomFunctions() {
+  std::string output;
+  ASSERT(compile(
+    "$end: zork(3);\n"
+    "@for $i from zork(1) through $end {\n"
+    "  a#{$i} { eq: $i == $end; sum: $i + $end; }\n"
+    "}\n", true, &output));
+  ASSERT(output ==
+    "a1zork{eq:false;sum:4zork}"
+    "a2zork{eq:false;sum:5zork}"
+    "a3zork{eq:true;sum:6zork}\n");
+  return true;
+}
+
+int main(int argc, char **argv) {
+  std::vector<std::string> passed;
+  std::vector<std::string> failed;
+  TEST(TestPeakOfLoops);
+  TEST(TestNoGrowthOverCompilations);
+  TEST(TestNoGrowthOfRuntimeNames);
+  TEST(TestNoGrowthOfSymbolTable);
+  TEST(TestUnitsOfCustomFunctions);
+  std::cerr << argv[0] << ": Passed: " << passed.size()
+            << ", failed: " << failed.size()
+            << "." << std::endl;
+  return failed.size();
+}
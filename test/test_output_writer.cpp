@@ -0,0 +1,129 @@
+#include "sass/context.h"
+#include "test_macros.hpp"
+
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Checks that the css passed to the output writer is the css stored as
+// the output string otherwise, that the body arrives in chunks while it
+// is rendered and that the hoisted preamble is passed last.
+
+namespace {
+
+  const size_t CHUNK = 64 * 1024;
+
+  // hoisted comment and import, a non-ascii char early in the
+  // body (streamed before the charset is decided) and a few
+  // hundred KB of css after it
+  const char* SOURCE =
+    "/*! top */\n"
+    "@import url(first.css);\n"
+    ".quote { content: \"\xE2\x80\x9C\"; }\n"
+    "@for $i from 1 through 8000 {\n"
+    "  .rule-#{$i} { width: $i * 1px; &:hover { color: red; } }\n"
+    "}\n"
+    "@import url(last.css);\n";
+
+  struct Received {
+    std::string body;
+    std::string preamble;
+    size_t body_chunks = 0;
+    bool body_after_preamble = false;
+    bool oversized = false;
+  };
+
+  void receive(const char* chunk, size_t length, enum Sass_Output_Part part, void* cookie) {
+    Received* received = static_cast<Received*>(cookie);
+    if (length > CHUNK) received->oversized = true;
+    if (part == SASS_OUTPUT_BODY) {
+      if (!received->preamble.empty()) received->body_after_preamble = true;
+      received->body.append(chunk, length);
+      ++received->body_chunks;
+    }
+    else {
+      received->preamble.append(chunk, length);
+    }
+  }
+
+  // returns the output string, or the css passed to `received`
+  std::string compile(Sass_Output_Style style, Received* received, bool embed = false) {
+    struct Sass_Data_Context* data_ctx = sass_make_data_context(sass_copy_c_string(SOURCE));
+    struct Sass_Context* ctx = sass_data_context_get_context(data_ctx);
+    struct Sass_Options* options = sass_data_context_get_options(data_ctx);
+    sass_option_set_output_style(options, style);
+    sass_option_set_source_map_embed(options, embed);
+    sass_option_set_source_map_file(options, "out.css.map");
+    if (received) {
+      sass_option_set_output_writer(options, receive);
+      sass_option_set_output_writer_cookie(options, received);
+    }
+    std::string output;
+    if (sass_compile_data_context(data_ctx) != 0) {
+      std::cerr << sass_context_get_error_message(ctx);
+      output = "error";
+    }
+    else if (received) {
+      // the css was only passed to the writer
+      if (sass_context_get_output_string(ctx)) output = "not null";
+      else output = received->preamble + received->body;
+    }
+    else {
+      output = sass_context_get_output_string(ctx);
+    }
+    sass_delete_data_context(data_ctx);
+    return output;
+  }
+
+  bool same_output(Sass_Output_Style style, bool embed = false) {
+    Received received;
+    std::string stored(compile(style, 0, embed));
+    ASSERT(stored.size() > 4 * CHUNK);
+    ASSERT(compile(style, &received, embed) == stored);
+    return true;
+  }
+
+}
+
+bool TestSameOutput() {
+  ASSERT(same_output(SASS_STYLE_NESTED));
+  ASSERT(same_output(SASS_STYLE_EXPANDED));
+  ASSERT(same_output(SASS_STYLE_COMPACT));
+  ASSERT(same_output(SASS_STYLE_COMPRESSED));
+  return true;
+}
+
+bool TestEmbeddedSourceMap() {
+  ASSERT(same_output(SASS_STYLE_NESTED, true));
+  ASSERT(same_output(SASS_STYLE_COMPRESSED, true));
+  return true;
+}
+
+bool TestChunks() {
+  Received received;
+  compile(SASS_STYLE_EXPANDED, &received);
+  ASSERT(!received.oversized);
+  // streamed in pieces, not passed in one go at the end
+  ASSERT(received.body_chunks >= received.body.size() / CHUNK);
+  ASSERT(received.body_chunks > 4);
+  ASSERT(!received.body_after_preamble);
+  // the charset is declared for the streamed non-ascii char
+  ASSERT(received.preamble.find("@charset \"UTF-8\";") == 0);
+  ASSERT(received.preamble.find("/*! top */") != std::string::npos);
+  ASSERT(received.preamble.find("@import url(last.css);") != std::string::npos);
+  ASSERT(received.body.find("@import") == std::string::npos);
+  return true;
+}
+
+int main(int argc, char **argv) {
+  std::vector<std::string> passed;
+  std::vector<std::string> failed;
+  TEST(TestSameOutput);
+  TEST(TestEmbeddedSourceMap);
+  TEST(TestChunks);
+  std::cerr << argv[0] << ": Passed: " << passed.size()
+            << ", failed: " << failed.size()
+            << "." << std::endl;
+  return failed.size();
+}
@@ -0,0 +1,108 @@
+#include "../src/persistent_map.hpp"
+#include "test_macros.hpp"
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+  // puts many keys into the same slots (and collision nodes)
+  struct BadHash {
+    size_t operator()(int key) const { return key % 4; }
+  };
+
+  typedef Sass::persistent_map<int, int> Map;
+  typedef Sass::persistent_map<int, int, BadHash> BadMap;
+
+  template <class M>
+  std::vector<int> keys(const M& map) {
+    std::vector<int> keys;
+    map.for_each([&](int key, int) { keys.push_back(key); });
+    return keys;
+  }
+
+}
+
+bool TestInsertFind() {
+  Map map;
+  for (int i = 0; i < 1000; ++i) ASSERT(map.insert(i, i * 2));
+  ASSERT(map.size() == 1000);
+  for (int i = 0; i < 1000; ++i) ASSERT(*map.find(i) == i * 2);
+  ASSERT(map.find(1000) == nullptr);
+  return true;
+}
+
+bool TestUpdateKeepsOrder() {
+  Map map;
+  map.insert(3, 0);
+  map.insert(1, 0);
+  map.insert(2, 0);
+  ASSERT(!map.insert(1, 5));
+  ASSERT(*map.find(1) == 5);
+  ASSERT(keys(map) == std::vector<int>({ 3, 1, 2 }));
+  return true;
+}
+
+bool TestCopiesAreIndependent() {
+  Map a;
+  for (int i = 0; i < 100; ++i) a.insert(i, i);
+  Map b = a;
+  Map c = a;
+  b.insert(100, 100);
+  b.insert(5, -5);
+  c.insert(200, 200);
+  c.erase(7);
+  ASSERT(a.size() == 100 && !a.has(100) && *a.find(5) == 5 && a.has(7));
+  ASSERT(b.size() == 101 && *b.find(5) == -5 && !b.has(200));
+  ASSERT(c.size() == 100 && !c.has(7) && !c.has(100));
+  ASSERT(keys(b).back() == 100);
+  ASSERT(keys(c).back() == 200);
+  return true;
+}
+
+bool TestEraseAndInsertAgain() {
+  Map map;
+  for (int i = 0; i < 10; ++i) map.insert(i, i);
+  ASSERT(map.erase(2));
+  ASSERT(!map.erase(2));
+  map.insert(2, 20);
+  ASSERT(keys(map) == std::vector<int>({ 0, 1, 3, 4, 5, 6, 7, 8, 9, 2 }));
+  return true;
+}
+
+bool TestCompaction() {
+  Map map;
+  for (int i = 0; i < 500; ++i) map.insert(i, i);
+  for (int i = 0; i < 500; ++i) if (i % 10) map.erase(i);
+  ASSERT(map.size() == 50);
+  std::vector<int> expected;
+  for (int i = 0; i < 500; i += 10) expected.push_back(i);
+  ASSERT(keys(map) == expected);
+  return true;
+}
+
+bool TestCollisions() {
+  BadMap map;
+  for (int i = 0; i < 100; ++i) map.insert(i, i);
+  for (int i = 0; i < 100; i += 2) map.erase(i);
+  ASSERT(map.size() == 50);
+  for (int i = 0; i < 100; ++i) ASSERT(map.has(i) == (i % 2 == 1));
+  ASSERT(keys(map).front() == 1);
+  return true;
+}
+
+int main(int argc, char **argv) {
+  std::vector<std::string> passed;
+  std::vector<std::string> failed;
+  TEST(TestInsertFind);
+  TEST(TestUpdateKeepsOrder);
+  TEST(TestCopiesAreIndependent);
+  TEST(TestEraseAndInsertAgain);
+  TEST(TestCompaction);
+  TEST(TestCollisions);
+  std::cerr << argv[0] << ": Passed: " << passed.size()
+            << ", failed: " << failed.size()
+            << "." << std::endl;
+  return failed.size();
+}
@@ -0,0 +1,277 @@
+#include "sass/context.h"
+#include "../src/sass.hpp"
+#include "../src/context.hpp"
+#include "../src/sass_context.hpp"
+#include "../src/serializer.hpp"
+#include "test_macros.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+// Checks that precompiled sidecars load the same tree the parser created,
+// that their imports are resolved again and that damaged sidecars are
+// never used, the stylesheet is parsed again.
+
+namespace {
+
+  const int CORRUPTIONS = 200;
+
+  // covers statements, expressions and selectors
+  const char* SOURCE =
+    "@charset \"UTF-8\";\n"
+    "/* comment */\n"
+    "$map: (a: 1px, b: 2em, 'c': null);\n"
+    "$list: 1 2, 3 4 !default;\n"
+    "@function double($n, $rest...) { @return $n * 2 + length($rest); }\n"
+    "@mixin box($w: 10px) { width: $w; @content; }\n"
+    "%placeholder { color: red; }\n"
+    "$w-default: 3px;\n"
+    ".a, .b > .c ~ d + e { @extend %placeholder; margin: -$w-default or 1px; }\n"
+    "@each $k, $v in $map { .item-#{$k} { value: $v; } }\n"
+    "@for $i from 1 through 3 { .n-#{$i} { z: double($i, a, b); } }\n"
+    "$j: 0;\n"
+    "@while $j < 2 { .w-#{$j} { w: if($j == 0, yes, no); } $j: $j + 1; }\n"
+    "@media screen and (min-width: 100px) { .m { @include box(5px) { height: 1%; } } }\n"
+    "@supports (display: grid) and (not (display: inline-grid)) { .s { display: grid; } }\n"
+    "@at-root .r { a[href^='http'] { b: c; } p:not(.x)::before { content: \"\\201C\"; } }\n"
+    "@keyframes spin { from { top: 0; } 50% { top: 1px; } to { top: 2px; } }\n"
+    "@font-face { font-family: x; src: url(x.woff); }\n"
+    ".p { &:hover { color: #fff; } & .q { color: rgba(0, 0, 0, .5); } }\n"
+    "@if 1 + 1 == 2 { .t { x: 1 / 2; y: (1/2); z: \"#{1}#{2}\"; } } @else { .f { x: y; } }\n";
+
+  std::string path() {
+    static std::string path = "build/serializer_" + std::to_string(getpid()) + ".scss";
+    return path;
+  }
+
+  std::string sidecar() {
+    return path() + ".sassc";
+  }
+
+  // stylesheet importing `partial()`
+  std::string importer() {
+    static std::string path = "build/serializer_import_" + std::to_string(getpid()) + ".scss";
+    return path;
+  }
+
+  std::string partial(const std::string& prefix = "_") {
+    return "build/" + prefix + "serializer_partial_" + std::to_string(getpid()) + ".scss";
+  }
+
+  bool write_file(const std::string& file, const std::string& data) {
+    std::ofstream out(file, std::ios::binary);
+    out << data;
+    return bool(out);
+  }
+
+  std::string read_file(const std::string& file) {
+    std::ifstream in(file, std::ios::binary);
+    std::stringstream data;
+    data << in.rdbuf();
+    return data.str();
+  }
+
+  // same as the serializer
+  uint64_t checksum(const char* data, size_t length) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < length; ++i) {
+      hash ^= static_cast<unsigned char>(data[i]);
+      hash *= 1099511628211ULL;
+    }
+    return hash;
+  }
+
+  // replaces the trailing checksum so the damage goes unnoticed
+  void reseal(std::string& data) {
+    data.resize(data.size() - 8);
+    uint64_t hash = checksum(data.data(), data.size());
+    for (size_t i = 0; i < 8; ++i) {
+      data.push_back(static_cast<char>((hash >> (i * 8)) & 0xff));
+    }
+  }
+
+  // returns the css, or the error message
+  std::string compile(bool precompiled, int* status = 0, const std::string& file = path()) {
+    struct Sass_File_Context* file_ctx = sass_make_file_context(file.c_str());
+    struct Sass_Context* ctx = sass_file_context_get_context(file_ctx);
+    struct Sass_Options* options = sass_file_context_get_options(file_ctx);
+    sass_option_set_load_precompiled(options, precompiled);
+    int result = sass_compile_file_context(file_ctx);
+    std::string output(result == 0
+      ? sass_context_get_output_string(ctx)
+      : sass_context_get_error_message(ctx));
+    sass_delete_file_context(file_ctx);
+    if (status) *status = result;
+    return output;
+  }
+
+  bool precompile(const std::string& file = path()) {
+    struct Sass_File_Context* file_ctx = sass_make_file_context(file.c_str());
+    int status = sass_precompile_file_context(file_ctx);
+    if (status != 0) {
+      std::cerr << sass_context_get_error_message(
+        sass_file_context_get_context(file_ctx));
+    }
+    sass_delete_file_context(file_ctx);
+    return status == 0;
+  }
+
+  // what a compilation does with the sidecar: nothing if null
+  // is returned, the parser takes over if an exception is thrown
+  enum Outcome { LOADED, IGNORED, REJECTED };
+
+  Outcome load(const std::string& data, std::string* again = 0) {
+    struct Sass_File_Context* file_ctx = sass_make_file_context(path().c_str());
+    Outcome outcome = REJECTED;
+    {
+      Sass::File_Context cpp_ctx(*file_ctx);
+      Sass::Memory::ArenaScope scope(cpp_ctx.arena);
+      try {
+        Sass::Deserializer deserializer(cpp_ctx, data,
+          Sass::SourceSpan(path().c_str(), SOURCE, 0));
+        Sass::Block_Obj root = deserializer.read_root();
+        outcome = root ? LOADED : IGNORED;
+        if (root && again) {
+          Sass::Serializer serializer(SOURCE);
+          serializer.write(root);
+          *again = serializer.data();
+        }
+      }
+      catch (Sass::SerializationError&) {}
+    }
+    sass_delete_file_context(file_ctx);
+    return outcome;
+  }
+
+}
+
+bool TestRoundTrip() {
+  ASSERT(write_file(path(), SOURCE));
+  ASSERT(precompile());
+  std::string data(read_file(sidecar()));
+  ASSERT(!data.empty());
+  // serializing the loaded tree gives the same data
+  std::string again;
+  ASSERT(load(data, &again) == LOADED);
+  ASSERT(again == data);
+  // and compiling it the same css
+  int status = 0;
+  std::string parsed(compile(false, &status));
+  ASSERT(status == 0);
+  ASSERT(compile(true) == parsed);
+  return true;
+}
+
+bool TestChangedSource() {
+  std::string data(read_file(sidecar()));
+  ASSERT(write_file(path(), std::string(SOURCE) + ".added { x: y; }\n"));
+  std::string parsed(compile(false));
+  ASSERT(compile(true) == parsed);
+  ASSERT(write_file(path(), SOURCE));
+  ASSERT(load(data) == LOADED);
+  return true;
+}
+
+// imports are resolved again with the path written in the stylesheet
+bool TestResolvedImports() {
+  std::string import("serializer_partial_" + std::to_string(getpid()));
+  ASSERT(write_file(importer(), "@import \"" + import + "\";\n"));
+  ASSERT(write_file(partial(), "a { b: c; }\n"));
+  ASSERT(precompile(importer()));
+  int status = 0;
+  ASSERT(compile(true, &status, importer()) == compile(false, 0, importer()));
+  ASSERT(status == 0);
+  // a second candidate makes the import ambiguous
+  ASSERT(write_file(partial(""), "a { b: d; }\n"));
+  std::string error(compile(true, &status, importer()));
+  ASSERT(status != 0);
+  ASSERT(error.find("It's not clear which file to import") != std::string::npos);
+  // the other candidate is found once the partial is gone
+  std::remove(partial().c_str());
+  ASSERT(compile(true, &status, importer()).find("b: d") != std::string::npos);
+  std::remove(partial("").c_str());
+  std::remove(importer().c_str());
+  std::remove((importer() + ".sassc").c_str());
+  return true;
+}
+
+bool TestCorruptedSidecar() {
+  std::string data(read_file(sidecar()));
+  std::string parsed(compile(false));
+  std::srand(1);
+  for (int i = 0; i < CORRUPTIONS; ++i) {
+    std::string damaged(data);
+    // keep the magic, anything after it may be damaged
+    for (int n = 0; n < 3; ++n) {
+      damaged[5 + std::rand() % (damaged.size() - 5)] ^= 1 << (std::rand() % 8);
+    }
+    // the checksum catches all of them
+    ASSERT(load(damaged) == IGNORED);
+    ASSERT(write_file(sidecar(), damaged));
+    ASSERT(compile(true) == parsed);
+  }
+  ASSERT(write_file(sidecar(), data));
+  return true;
+}
+
+bool TestTruncatedSidecar() {
+  std::string data(read_file(sidecar()));
+  for (size_t size = 0; size < data.size(); size += 7) {
+    ASSERT(load(data.substr(0, size)) == IGNORED);
+  }
+  return true;
+}
+
+bool TestInvalidTree() {
+  std::string data(read_file(sidecar()));
+  std::string parsed(compile(false));
+  std::srand(2);
+  // damage the checksum can't catch must not crash the loader, the
+  // sidecar is rejected (the source is parsed) or the tree compiles
+  // (to css or a clean error)
+  int loaded = 0;
+  for (int i = 0; i < CORRUPTIONS; ++i) {
+    std::string damaged(data);
+    damaged[40 + std::rand() % (damaged.size() - 48)] ^= 1 << (std::rand() % 8);
+    reseal(damaged);
+    Outcome outcome = load(damaged);
+    ASSERT(write_file(sidecar(), damaged));
+    int status = 0;
+    std::string output(compile(true, &status));
+    if (outcome == LOADED) {
+      ASSERT(status == 0 || !output.empty());
+      ++loaded;
+    }
+    else {
+      ASSERT(output == parsed);
+    }
+  }
+  std::printf("damaged trees loaded: %d of %d\n", loaded, CORRUPTIONS);
+  // nearly all of them are rejected
+  ASSERT(loaded < CORRUPTIONS / 20);
+  std::remove(path().c_str());
+  std::remove(sidecar().c_str());
+  return true;
+}
+
+int main(int argc, char **argv) {
+  std::vector<std::string> passed;
+  std::vector<std::string> failed;
+  TEST(TestRoundTrip);
+  TEST(TestChangedSource);
+  TEST(TestResolvedImports);
+  TEST(TestCorruptedSidecar);
+  TEST(TestTruncatedSidecar);
+  TEST(TestInvalidTree);
+  std::cerr << argv[0] << ": Passed: " << passed.size()
+            << ", failed: " << failed.size()
+            << "." << std::endl;
+  return failed.size();
+}
@@ -1,15 +1,11 @@
 #include "../src/memory/SharedPtr.hpp"
+#include "test_macros.hpp"
 
 #include <iostream>
 #include <memory>
 #include <sstream>
 #include <string>
-
-#define ASSERT(cond) \
-  if (!(cond)) { \
-    std::cerr << "Assertion failed: " #cond " at " __FILE__ << ":" << __LINE__ << std::endl; \
-    return false; \
-  } \
+#include <thread>
 
 class TestObj : public Sass::SharedObj {
  public:
@@ -161,13 +157,74 @@ bool TestComparisonWithNullptr() {
   return true;
 }
 
-#define TEST(fn) \
-  if (fn()) { \
-    passed.push_back(#fn); \
-  } else { \
-    failed.push_back(#fn); \
-    std::cerr << "Failed: " #fn << std::endl; \
-  } \
+bool TestArenaAllocation() {
+  bool destroyed = false;
+  Sass::Memory::Arena* arena = Sass::Memory::Arena::create();
+  {
+    Sass::Memory::ArenaScope scope(arena);
+    ASSERT(Sass::Memory::Arena::current() == arena);
+    SharedTestObj a = new TestObj(&destroyed);
+    SharedTestObj b = new TestObj(&destroyed);
+    ASSERT(arena->allocated() == 2);
+    TestObj* ptr = b.ptr();
+    b = a;
+    ASSERT(arena->allocated() == 1);
+    // released blocks are recycled
+    SharedTestObj c = new TestObj(&destroyed);
+    ASSERT(c.ptr() == ptr);
+  }
+  ASSERT(destroyed);
+  ASSERT(arena->allocated() == 0);
+  ASSERT(Sass::Memory::Arena::current() == nullptr);
+  arena->release();
+  return true;
+}
+
+bool TestArenaOutlivesOwner() {
+  bool destroyed = false;
+  Sass::Memory::Arena* arena = Sass::Memory::Arena::create();
+  SharedTestObj a;
+  {
+    Sass::Memory::ArenaScope scope(arena);
+    a = new TestObj(&destroyed);
+  }
+  // arena must stay alive until `a` is gone
+  arena->release();
+  ASSERT(!destroyed);
+  a = SharedTestObj();
+  ASSERT(destroyed);
+  return true;
+}
+
+bool TestArenaForeignRelease() {
+  bool destroyed = false;
+  Sass::Memory::Arena* arena = Sass::Memory::Arena::create();
+  Sass::Memory::ArenaScope scope(arena);
+  SharedTestObj a = new TestObj(&destroyed);
+  TestObj* ptr = a.ptr();
+  // released where the arena is not active
+  std::thread other([&a]() { a = SharedTestObj(); });
+  other.join();
+  ASSERT(destroyed);
+  ASSERT(arena->allocated() == 0);
+  // the owner takes the block back
+  SharedTestObj b = new TestObj(&destroyed);
+  ASSERT(b.ptr() == ptr);
+  ASSERT(arena->allocated() == 1);
+  b = SharedTestObj();
+  arena->release();
+  return true;
+}
+
+bool TestAllocationWithoutArena() {
+  bool destroyed = false;
+  ASSERT(Sass::Memory::Arena::current() == nullptr);
+  {
+    SharedTestObj a = new TestObj(&destroyed);
+  }
+  ASSERT(destroyed);
+  return true;
+}
 
 int main(int argc, char **argv) {
   std::vector<std::string> passed;
@@ -183,6 +240,10 @@ int main(int argc, char **argv) {
   TEST(TestDetachNull);
   TEST(TestComparisonWithSharedPtr);
   TEST(TestComparisonWithNullptr);
+  TEST(TestArenaAllocation);
+  TEST(TestArenaOutlivesOwner);
+  TEST(TestArenaForeignRelease);
+  TEST(TestAllocationWithoutArena);
   std::cerr << argv[0] << ": Passed: " << passed.size()
             << ", failed: " << failed.size()
             << "." << std::endl;
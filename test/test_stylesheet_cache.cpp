@@ -0,0 +1,216 @@
+#include "sass/context.h"
+#include "test_macros.hpp"
+
+#include <sys/stat.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Checks that stylesheets cached between compilations are parsed again
+// when they or the files their imports resolve to change, that the cache
+// is shared by the threads of a batch and that entries stored in a cache
+// directory are used by compilations starting with an empty cache.
+
+namespace {
+
+  std::string dir() {
+    static std::string dir = "build/cache_" + std::to_string(getpid());
+    return dir;
+  }
+
+  bool write_file(const std::string& file, const std::string& data) {
+    std::ofstream out(file, std::ios::binary);
+    out << data;
+    return bool(out);
+  }
+
+  std::string read_file(const std::string& file) {
+    std::ifstream in(file, std::ios::binary);
+    std::stringstream data;
+    data << in.rdbuf();
+    return data.str();
+  }
+
+  bool contains(const std::string& css, const std::string& text) {
+    return css.find(text) != std::string::npos;
+  }
+
+  // files in the cache directory
+  std::vector<std::string> stored() {
+    std::vector<std::string> files;
+    if (DIR* handle = opendir((dir() + "/store").c_str())) {
+      while (struct dirent* entry = readdir(handle)) {
+        std::string name(entry->d_name);
+        if (name != "." && name != "..") files.push_back(dir() + "/store/" + name);
+      }
+      closedir(handle);
+    }
+    return files;
+  }
+
+  struct Sass_File_Context* make_context(bool cache) {
+    std::string path(dir() + "/main.scss");
+    struct Sass_File_Context* file_ctx = sass_make_file_context(path.c_str());
+    struct Sass_Options* options = sass_file_context_get_options(file_ctx);
+    sass_option_set_stylesheet_cache(options, cache);
+    sass_option_set_include_path(options, (dir() + "/inc").c_str());
+    return file_ctx;
+  }
+
+  // returns the css, or the error message
+  std::string result(struct Sass_File_Context* file_ctx) {
+    struct Sass_Context* ctx = sass_file_context_get_context(file_ctx);
+    std::string output(sass_context_get_error_status(ctx) == 0
+      ? sass_context_get_output_string(ctx)
+      : sass_context_get_error_message(ctx));
+    sass_delete_file_context(file_ctx);
+    return output;
+  }
+
+  std::string compile(bool cache = true) {
+    struct Sass_File_Context* file_ctx = make_context(cache);
+    sass_compile_file_context(file_ctx);
+    return result(file_ctx);
+  }
+
+  std::string compile_stored() {
+    struct Sass_File_Context* file_ctx = make_context(true);
+    struct Sass_Options* options = sass_file_context_get_options(file_ctx);
+    sass_option_set_stylesheet_cache_path(options, (dir() + "/store").c_str());
+    sass_compile_file_context(file_ctx);
+    return result(file_ctx);
+  }
+
+  // returns the source map
+  std::string compile_map(bool cache) {
+    struct Sass_File_Context* file_ctx = make_context(cache);
+    struct Sass_Context* ctx = sass_file_context_get_context(file_ctx);
+    struct Sass_Options* options = sass_file_context_get_options(file_ctx);
+    sass_option_set_source_map_file(options, (dir() + "/main.css.map").c_str());
+    sass_compile_file_context(file_ctx);
+    const char* map = sass_context_get_source_map_string(ctx);
+    std::string output(map ? map : "");
+    sass_delete_file_context(file_ctx);
+    return output;
+  }
+
+}
+
+bool TestSetup() {
+  mkdir(dir().c_str(), 0755);
+  mkdir((dir() + "/inc").c_str(), 0755);
+  ASSERT(write_file(dir() + "/main.scss", "@import \"x\";\n"));
+  ASSERT(write_file(dir() + "/inc/_x.scss", "a { from: inc; }\n"));
+  ASSERT(contains(compile(), "from: inc"));
+  return true;
+}
+
+// the import is now found next to the stylesheet
+bool TestAddedCandidate() {
+  ASSERT(write_file(dir() + "/_x.scss", "a { from: local; }\n"));
+  ASSERT(contains(compile(), "from: local"));
+  ASSERT(contains(compile(), "from: local"));
+  return true;
+}
+
+bool TestRemovedCandidate() {
+  ASSERT(std::remove((dir() + "/_x.scss").c_str()) == 0);
+  ASSERT(contains(compile(), "from: inc"));
+  return true;
+}
+
+// two candidates for the same import are an error
+bool TestAmbiguousCandidate() {
+  ASSERT(write_file(dir() + "/inc/x.scss", "a { from: other; }\n"));
+  ASSERT(contains(compile(), "It's not clear which file to import"));
+  ASSERT(std::remove((dir() + "/inc/x.scss").c_str()) == 0);
+  ASSERT(contains(compile(), "from: inc"));
+  return true;
+}
+
+// changed within the same second (same modification time)
+bool TestChangedImport() {
+  ASSERT(write_file(dir() + "/inc/_x.scss", "a { from: changed; }\n"));
+  ASSERT(contains(compile(), "from: changed"));
+  ASSERT(write_file(dir() + "/inc/_x.scss", "a { from: inc; }\n"));
+  ASSERT(contains(compile(), "from: inc"));
+  return true;
+}
+
+// spans of cached trees point into the resources of each compilation
+bool TestSourceMap() {
+  ASSERT(write_file(dir() + "/main.scss", "@import \"x\";\nb {\n  c: d;\n}\n"));
+  std::string parsed(compile_map(false));
+  ASSERT(contains(parsed, "\"mappings\""));
+  ASSERT(compile_map(true) == parsed);
+  ASSERT(compile_map(true) == parsed);
+  return true;
+}
+
+// all workers use the trees cached by the calling thread
+bool TestBatch() {
+  std::string css(compile());
+  std::vector<struct Sass_File_Context*> ctxs;
+  for (int i = 0; i < 16; ++i) ctxs.push_back(make_context(true));
+  ASSERT(sass_compile_batch(ctxs.data(), ctxs.size(), 4) == 0);
+  for (struct Sass_File_Context* file_ctx : ctxs) {
+    ASSERT(result(file_ctx) == css);
+  }
+  return true;
+}
+
+bool TestStoredEntries() {
+  std::string css(compile(false));
+  mkdir((dir() + "/store").c_str(), 0755);
+  sass_clear_stylesheet_cache();
+  ASSERT(compile_stored() == css);
+  // one entry for each file
+  ASSERT(stored().size() == 2);
+  // loaded by a compilation with an empty cache
+  sass_clear_stylesheet_cache();
+  ASSERT(compile_stored() == css);
+  // damaged entries are replaced
+  for (const std::string& file : stored()) {
+    ASSERT(write_file(file, "SASSC damaged"));
+  }
+  sass_clear_stylesheet_cache();
+  ASSERT(compile_stored() == css);
+  for (const std::string& file : stored()) {
+    ASSERT(read_file(file).size() > 13);
+  }
+  return true;
+}
+
+bool TestCleanup() {
+  for (const std::string& file : stored()) std::remove(file.c_str());
+  rmdir((dir() + "/store").c_str());
+  std::remove((dir() + "/inc/_x.scss").c_str());
+  std::remove((dir() + "/main.scss").c_str());
+  rmdir((dir() + "/inc").c_str());
+  rmdir(dir().c_str());
+  sass_clear_stylesheet_cache();
+  return true;
+}
+
+int main(int argc, char **argv) {
+  std::vector<std::string> passed;
+  std::vector<std::string> failed;
+  TEST(TestSetup);
+  TEST(TestAddedCandidate);
+  TEST(TestRemovedCandidate);
+  TEST(TestAmbiguousCandidate);
+  TEST(TestChangedImport);
+  TEST(TestSourceMap);
+  TEST(TestBatch);
+  TEST(TestStoredEntries);
+  TEST(TestCleanup);
+  std::cerr << argv[0] << ": Passed: " << passed.size()
+            << ", failed: " << failed.size()
+            << "." << std::endl;
+  return failed.size();
+}
@@ -181,6 +181,30 @@ bool Test_ascii_isspace() {
   return true;
 }
 
+bool TestFormatFixed() {
+  ASSERT_STR_EQ("0.0000000000", Sass::Util::format_fixed(0, 10));
+  ASSERT_STR_EQ("-0.00", Sass::Util::format_fixed(-0.0, 2));
+  ASSERT_STR_EQ("12.5000", Sass::Util::format_fixed(12.5, 4));
+  ASSERT_STR_EQ("0.3333333333", Sass::Util::format_fixed(1.0 / 3, 10));
+  ASSERT_STR_EQ("-0.6666666667", Sass::Util::format_fixed(-2.0 / 3, 10));
+  ASSERT_STR_EQ("0.1000000000000000055511", Sass::Util::format_fixed(0.1, 22));
+  ASSERT_STR_EQ("1000", Sass::Util::format_fixed(999.5, 0));
+  ASSERT_STR_EQ("-10.0", Sass::Util::format_fixed(-9.96, 1));
+  ASSERT_STR_EQ("0.0000000001", Sass::Util::format_fixed(5e-11 + 1e-20, 10));
+  ASSERT_STR_EQ("18000000000000000000", Sass::Util::format_fixed(1.8e19, 0));
+  return true;
+}
+
+bool TestFormatFixedTiesToEven() {
+  ASSERT_STR_EQ("2", Sass::Util::format_fixed(2.5, 0));
+  ASSERT_STR_EQ("4", Sass::Util::format_fixed(3.5, 0));
+  ASSERT_STR_EQ("0.12", Sass::Util::format_fixed(0.125, 2));
+  ASSERT_STR_EQ("0.38", Sass::Util::format_fixed(0.375, 2));
+  // 1.005 is slightly below the tie as a double
+  ASSERT_STR_EQ("1.00", Sass::Util::format_fixed(1.005, 2));
+  return true;
+}
+
 }  // namespace
 
 #define TEST(fn) \
@@ -210,6 +234,8 @@ int main(int argc, char **argv) {
   TEST(Test_ascii_isalpha);
   TEST(Test_ascii_isxdigit);
   TEST(Test_ascii_isspace);
+  TEST(TestFormatFixed);
+  TEST(TestFormatFixedTiesToEven);
   std::cerr << argv[0] << ": Passed: " << passed.size()
             << ", failed: " << failed.size()
             << "." << std::endl;
@@ -0,0 +1,176 @@
+#include "../src/sass.hpp"
+#include "../src/ast.hpp"
+#include "test_macros.hpp"
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Checks the elements of lists, which share their buffer between copies
+// (`shared_vector`): copies share the elements until one of them is changed,
+// appends in place never reach other copies and writes after a copy never
+// reach it.
+
+using namespace Sass;
+
+namespace {
+
+  SourceSpan pstate("[test]");
+
+  ExpressionObj str(const char* value) {
+    return SASS_MEMORY_NEW(String_Constant, pstate, value);
+  }
+
+  List* list(std::vector<const char*> values) {
+    List* list = SASS_MEMORY_NEW(List, pstate);
+    for (const char* value : values) list->append(str(value));
+    return list;
+  }
+
+  // the values of the elements, separated by spaces
+  std::string values(const List* list) {
+    std::string values;
+    for (const ExpressionObj& item : list->elements()) {
+      if (!values.empty()) values += " ";
+      values += Cast<String_Constant>(item)->value();
+    }
+    return values;
+  }
+
+  const ExpressionObj* data(const List* list) {
+    return &list->elements()[0];
+  }
+
+}
+
+bool TestCopiesShareUntilChanged() {
+  List_Obj a = list({ "a", "b", "c" });
+  List_Obj b = SASS_MEMORY_COPY(a);
+  ASSERT(data(a) == data(b));
+  b->set(0, str("x"));
+  ASSERT(data(a) != data(b));
+  ASSERT(values(a) == "a b c");
+  ASSERT(values(b) == "x b c");
+  return true;
+}
+
+bool TestAppendToCopies() {
+  List_Obj a = list({ "a", "b", "c" });
+  List_Obj b = SASS_MEMORY_COPY(a);
+  b->append(str("d"));
+  // the second copy must not write over the append of the first
+  List_Obj c = SASS_MEMORY_COPY(a);
+  c->append(str("e"));
+  ASSERT(values(a) == "a b c");
+  ASSERT(values(b) == "a b c d");
+  ASSERT(values(c) == "a b c e");
+  // appending to a copy at the end of the buffer
+  // is seen by neither the original nor its copies
+  List_Obj d = SASS_MEMORY_COPY(b);
+  b->append(str("f"));
+  d->append(str("g"));
+  ASSERT(values(b) == "a b c d f");
+  ASSERT(values(d) == "a b c d g");
+  return true;
+}
+
+bool TestAppendInPlace() {
+  List_Obj a = list({ "a" });
+  // each copy appends to the buffer of the previous
+  // one, new buffers are only needed to grow
+  int copied = 0;
+  for (int i = 0; i < 1000; ++i) {
+    List_Obj b = SASS_MEMORY_COPY(a);
+    b->append(str("b"));
+    if (data(a) != data(b)) ++copied;
+    a = b;
+  }
+  ASSERT(a->length() == 1001);
+  ASSERT(copied <= 10);
+  return true;
+}
+
+bool TestAppendToOriginal() {
+  List_Obj a = list({ "a", "b" });
+  List_Obj b = SASS_MEMORY_COPY(a);
+  a->append(str("c"));
+  b->append(str("d"));
+  ASSERT(values(a) == "a b c");
+  ASSERT(values(b) == "a b d");
+  return true;
+}
+
+bool TestWritesAfterCopy() {
+  List_Obj a = list({ "a", "b" });
+  List_Obj b = SASS_MEMORY_COPY(a);
+  b->append(str("c"));
+  a->set(0, str("x"));
+  b->set(1, str("y"));
+  ASSERT(values(a) == "x b");
+  ASSERT(values(b) == "a y c");
+  a->erase(a->begin());
+  b->insert(b->begin(), str("z"));
+  ASSERT(values(a) == "b");
+  ASSERT(values(b) == "z a y c");
+  return true;
+}
+
+// reading through non-const lists never copies the shared buffer
+bool TestNonConstReads() {
+  List_Obj a = list({ "a", "b", "c" });
+  List_Obj b = SASS_MEMORY_COPY(a);
+  List* reader = b.ptr();
+  const ExpressionObj& first = (*reader)[0];
+  ASSERT(reader->at(1) == reader->elements()[1]);
+  ASSERT(reader->first() == first && reader->last() == *(reader->end() - 1));
+  ASSERT(*reader->begin() == first);
+  ASSERT(data(a) == data(b));
+  // a reference taken before the change still reads the shared element
+  b->set(0, str("x"));
+  ASSERT(Cast<String_Constant>(first)->value() == "a");
+  ASSERT(values(a) == "a b c");
+  ASSERT(values(b) == "x b c");
+  return true;
+}
+
+bool TestOriginalGone() {
+  List_Obj b;
+  {
+    List_Obj a = list({ "a", "b" });
+    b = SASS_MEMORY_COPY(a);
+    a->append(str("c"));
+  }
+  // the element of the original is dropped
+  b->append(str("d"));
+  ASSERT(values(b) == "a b d");
+  return true;
+}
+
+bool TestConcatOwnElements() {
+  List_Obj a = list({ "a", "b" });
+  List_Obj b = SASS_MEMORY_NEW(List, pstate);
+  // shares the elements of [a], then appends them again
+  b->concat(a);
+  b->concat(a);
+  b->concat(b);
+  ASSERT(values(a) == "a b");
+  ASSERT(values(b) == "a b a b a b a b");
+  return true;
+}
+
+int main(int argc, char **argv) {
+  std::vector<std::string> passed;
+  std::vector<std::string> failed;
+  TEST(TestCopiesShareUntilChanged);
+  TEST(TestAppendToCopies);
+  TEST(TestAppendInPlace);
+  TEST(TestAppendToOriginal);
+  TEST(TestWritesAfterCopy);
+  TEST(TestNonConstReads);
+  TEST(TestOriginalGone);
+  TEST(TestConcatOwnElements);
+  std::cerr << argv[0] << ": Passed: " << passed.size()
+            << ", failed: " << failed.size()
+            << "." << std::endl;
+  return failed.size();
+}